@@ -0,0 +1,14 @@
+@echo off
+chcp 65001 >nul
+
+rem 로더 벤치마크 (창 없이 합성 OBJ 를 만들어 loadOBJ 를 단계별로 잰다)
+rem 사용법: build_bench.bat [최대 삼각형 수]   (기본 1000000, 최대 50000000)
+
+g++ main.cpp glad_4.6/src/glad.c -O2 -DLOADER_BENCH -mconsole -I"glfw_3.4/include" -I"glad_4.6/include" -I"glm_0.9.9.8" -L"glfw_3.4/lib-mingw-w64" -lglfw3 -lopengl32 -lgdi32 -luser32 -lshell32 -o loader_bench.exe
+
+if %errorlevel%==0 (
+    echo [Success] Build Success! Run loader_bench.exe
+    loader_bench.exe %1
+) else (
+  echo [Failure] Build Error!
+)
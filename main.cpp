@@ -1,247 +1,6422 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#define PSAPI_VERSION 2 // K32GetProcessMemoryInfo (kernel32, psapi 링크 불필요)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define HAS_SSE 1
+#include <xmmintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+// ===== Allocation Counter =====
+// --bench-load 가 보고하는 할당 횟수 (operator new 기준, malloc 을 직접 부르는 stb 등은 세지 않는다).
+// 전역 operator new 를 바꾸는 건 벤치마크 빌드(build_bench.bat, -DLOADER_BENCH)에서만 한다.
+// 일반 뷰어에서는 카운터가 0 으로 남고 --bench-load 표의 allocs 칸은 "-" 로 나온다.
+std::atomic<uint64_t> allocationCount{0};
+
+#ifdef LOADER_BENCH
+// delete 만 호출 지점에 인라인되면 GCC 가 new 로 받은 포인터를 free 한다고 경고하므로 인라인을 막는다.
+#if defined(__GNUC__)
+#define NO_INLINE __attribute__((noinline))
+#else
+#define NO_INLINE
+#endif
+
+NO_INLINE void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+NO_INLINE void operator delete(void* p) noexcept { free(p); }
+NO_INLINE void operator delete(void* p, size_t) noexcept { free(p); }
+#endif
+
+// ===== Vertex Shader =====
+const char* vertexShaderSource = R"(
+#version 330 core
+precision mediump float;
+
+uniform mat4 worldMat, viewMat, projMat;
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 texCoord;
+layout(location = 3) in vec4 tangent;
+
+out vec3 v_normal;
+out vec4 v_tangent;
+out vec2 v_texCoord;
+
+void main() {
+    gl_Position = projMat * viewMat * worldMat * vec4(position, 1.0);
+    v_normal = mat3(transpose(inverse(worldMat))) * normal;
+    v_tangent = vec4(mat3(worldMat) * tangent.xyz, tangent.w);
+    v_texCoord = texCoord;
+}
+)";
+
+// ===== Vertex Shader (양자화 정점) =====
+// position: AABB 기준 snorm16, normal: 옥타헤드럴 snorm16, texCoord: half float.
+// 정수 그대로 받아서 직접 나눈다 (GL 버전별 snorm 변환 규칙 차이를 피하기 위해).
+const char* quantizedVertexShaderSource = R"(
+#version 330 core
+precision mediump float;
+
+uniform mat4 worldMat, viewMat, projMat;
+uniform vec3 boundsCenter, boundsExtent;
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec2 normal;
+layout(location = 2) in vec2 texCoord;
+layout(location = 3) in vec4 tangent;
+
+out vec3 v_normal;
+out vec4 v_tangent;
+out vec2 v_texCoord;
+
+vec3 octahedralDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        vec2 s = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * s;
+    }
+    return normalize(n);
+}
+
+void main() {
+    vec3 pos = boundsCenter + max(position / 32767.0, -1.0) * boundsExtent;
+    vec3 nor = octahedralDecode(max(normal / 32767.0, -1.0));
+    gl_Position = projMat * viewMat * worldMat * vec4(pos, 1.0);
+    v_normal = mat3(transpose(inverse(worldMat))) * nor;
+    v_tangent = vec4(mat3(worldMat) * tangent.xyz, tangent.w);
+    v_texCoord = texCoord;
+}
+)";
+
+// ===== Fragment Shader =====
+const char* fragmentShaderSource = R"(
+#version 330 core
+precision mediump float;
+
+in vec3 v_normal;
+in vec2 v_texCoord;
+
+uniform sampler2D textureSampler;
+uniform vec3 diffuseColor; // MTL Kd (재질이 없으면 1)
+
+layout(location = 0) out vec4 fragColor;
+
+void main() {
+    fragColor = texture(textureSampler, v_texCoord) * vec4(diffuseColor, 1.0);
+}
+)";
+
+// ===== Camera Class =====
+class Camera {
+public:
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+    float sensitivity;
+
+    Camera() : position(0.0f, 0.0f, 5.0f), yaw(-90.0f), pitch(0.0f), sensitivity(0.1f) {}
+
+    glm::vec3 GetFront() const {
+        glm::vec3 front;
+        front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+        front.y = sin(glm::radians(pitch));
+        front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+        return glm::normalize(front);
+    }
+
+    glm::mat4 GetViewMatrix() {
+        return glm::lookAt(position, position + GetFront(), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    void ProcessMouseMovement(float xoffset, float yoffset) {
+        xoffset *= sensitivity;
+        yoffset *= sensitivity;
+
+        yaw += xoffset;
+        pitch += yoffset;
+
+        if (pitch > 89.0f) pitch = 89.0f;
+        if (pitch < -89.0f) pitch = -89.0f;
+    }
+};
+
+// Global camera instance
+Camera camera;
+
+// Mouse state
+float lastX = 400.0f, lastY = 300.0f;
+bool firstMouse = true;
+bool pickRequested = false; // 왼쪽 클릭 -> 다음 프레임에 화면 중앙 레이로 피킹
+
+// Mouse callback
+void mouse_callback(GLFWwindow*, double xpos, double ypos) {
+    float xposf = static_cast<float>(xpos);
+    float yposf = static_cast<float>(ypos);
+
+    if (firstMouse) {
+        lastX = xposf;
+        lastY = yposf;
+        firstMouse = false;
+    }
+
+    float xoffset = xposf - lastX;
+    float yoffset = lastY - yposf; // reversed since y-coordinates range from bottom to top
+    lastX = xposf;
+    lastY = yposf;
+
+    camera.ProcessMouseMovement(xoffset, yoffset);
+}
+
+// 커서가 숨겨진 마우스 룩 모드라 클릭 지점은 항상 화면 중앙 (카메라 정면)
+void mouse_button_callback(GLFWwindow*, int button, int action, int) {
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+        pickRequested = true;
+}
+
+// ===== Vertex/ObjData =====
+struct Vertex {
+    glm::vec3 pos;
+    glm::vec3 nor;
+    glm::vec2 tex;
+};
+
+// 16바이트 양자화 정점 (quantizeVertices 참고)
+struct PackedVertex {
+    int16_t pos[4];   // AABB 기준 snorm16, [3]은 정렬용
+    int16_t nor[2];   // 옥타헤드럴 snorm16
+    uint16_t tex[2];  // half float
+};
+
+enum class VertexFormat : uint32_t { Float, Quantized };
+
+enum class IndexFormat : uint32_t { UInt8, UInt16, UInt32 };
+
+// 하나의 draw 로 그리는 인덱스 구간. 인덱스는 baseVertex 기준 로컬 값이다.
+struct MeshChunk {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    uint32_t baseVertex;
+    uint32_t vertexCount;
+};
+
+// 연속된 인덱스 구간 하나 + 컬링용 바운딩 구와 법선 콘 (buildMeshlets 참고)
+struct Meshlet {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    uint32_t baseVertex;
+    float center[3];
+    float radius;
+    float coneAxis[3];
+    float coneCutoff;   // 1 이면 뒷면 컬링 안 함
+};
+
+// LOD 하나의 인덱스 구간 (buildLods 참고). 모든 LOD 가 같은 정점 버퍼를 쓴다.
+struct MeshLod {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    uint32_t meshletOffset;  // buildMeshlets() 결과 중 이 LOD 의 클러스터 구간
+    uint32_t meshletCount;
+    float error;             // 원본 대비 최대 오차 / 모델 반지름
+};
+
+// MTL 재질 하나 (newmtl). diffuseMap 은 실행 위치 기준으로 풀어 둔 경로, 없으면 빈 문자열.
+struct Material {
+    std::string name;
+    glm::vec3 diffuse{1.0f};   // Kd
+    std::string diffuseMap;    // map_Kd
+};
+
+// 한 재질로 그리는 인덱스 구간. LOD 마다 따로 있고, 한 LOD 안에서는 텍스처가 같은 재질끼리
+// 붙도록 정렬돼 있다 (loadOBJ 참고).
+struct Submesh {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    uint32_t material;
+};
+
+struct ObjData {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+
+    // loadOBJ() 가 구하는 위치 AABB 와 바운딩 구 (중심은 AABB 중심)
+    glm::vec3 boundsMin{0.0f};
+    glm::vec3 boundsMax{0.0f};
+    glm::vec3 sphereCenter{0.0f};
+    float sphereRadius = 0.0f;
+
+    // usemtl 이 있는 OBJ 만: 재질과 재질별 인덱스 구간 (비어 있으면 기본 텍스처 하나로 전체를 그림)
+    std::vector<Material> materials;
+    std::vector<Submesh> submeshes;
+
+    // generateTangents() 결과: 정점마다 xyz = 탄젠트, w = 바이탄젠트 부호 (비어 있으면 없음)
+    std::vector<glm::vec4> tangents;
+
+    // packIndices() 결과: GPU 업로드용으로 indexFormat 크기에 맞춰 압축한 인덱스
+    IndexFormat indexFormat = IndexFormat::UInt32;
+    std::vector<unsigned char> packedIndices;
+    std::vector<MeshChunk> chunks;
+
+    // buildMeshlets() 결과
+    std::vector<Meshlet> meshlets;
+
+    // buildLods() 결과: indices 는 LOD0, LOD1, ... 구간을 이어 붙인 것 (비어 있으면 LOD 없음)
+    std::vector<MeshLod> lods;
+
+    // quantizeVertices() 결과: vertexFormat 이 Quantized 면 GPU 에는 packedVertices 를 올린다
+    VertexFormat vertexFormat = VertexFormat::Float;
+    std::vector<PackedVertex> packedVertices;
+};
+
+// GPU 업로드에 필요한 최종 메시. ObjData 또는 매핑된 .meshbin 캐시를 가리킨다.
+struct MeshView {
+    const void* vertices = nullptr;
+    size_t vertexCount = 0;
+    VertexFormat vertexFormat = VertexFormat::Float;
+    const glm::vec4* tangents = nullptr; // 별도 스트림, 없으면 nullptr
+    glm::vec3 boundsMin{0.0f};
+    glm::vec3 boundsMax{0.0f};
+    glm::vec3 sphereCenter{0.0f};
+    float sphereRadius = 0.0f;
+    const void* indices = nullptr;
+    size_t indexCount = 0;
+    IndexFormat indexFormat = IndexFormat::UInt32;
+    const MeshChunk* chunks = nullptr;
+    size_t chunkCount = 0;
+    const Meshlet* meshlets = nullptr;
+    size_t meshletCount = 0;
+    const MeshLod* lods = nullptr;
+    size_t lodCount = 0;
+    const Submesh* submeshes = nullptr;
+    size_t submeshCount = 0;
+    const Material* materials = nullptr;
+    size_t materialCount = 0;
+};
+
+size_t vertexFormatSize(VertexFormat format) {
+    return format == VertexFormat::Quantized ? sizeof(PackedVertex) : sizeof(Vertex);
+}
+
+MeshView makeMeshView(const ObjData& objData) {
+    MeshView view;
+    view.vertexFormat = objData.vertexFormat;
+    if (objData.vertexFormat == VertexFormat::Quantized)
+        view.vertices = objData.packedVertices.data();
+    else
+        view.vertices = objData.vertices.data();
+    view.vertexCount = objData.vertices.size();
+    view.tangents = objData.tangents.empty() ? nullptr : objData.tangents.data();
+    view.boundsMin = objData.boundsMin;
+    view.boundsMax = objData.boundsMax;
+    view.sphereCenter = objData.sphereCenter;
+    view.sphereRadius = objData.sphereRadius;
+    view.indices = objData.packedIndices.data();
+    view.indexCount = objData.indices.size();
+    view.indexFormat = objData.indexFormat;
+    view.chunks = objData.chunks.data();
+    view.chunkCount = objData.chunks.size();
+    view.meshlets = objData.meshlets.data();
+    view.meshletCount = objData.meshlets.size();
+    view.lods = objData.lods.empty() ? nullptr : objData.lods.data();
+    view.lodCount = objData.lods.size();
+    view.submeshes = objData.submeshes.data();
+    view.submeshCount = objData.submeshes.size();
+    view.materials = objData.materials.data();
+    view.materialCount = objData.materials.size();
+    return view;
+}
+
+// 삼각형 순서를 바꾸는 패스가 넘지 말아야 할 인덱스 구간: 재질 구간마다 하나, 없으면 LOD 마다
+// 하나, LOD 도 없으면 전체
+std::vector<MeshLod> indexRanges(const ObjData& objData) {
+    if (!objData.submeshes.empty()) {
+        std::vector<MeshLod> ranges;
+        for (const Submesh& s : objData.submeshes)
+            ranges.push_back({s.indexOffset, s.indexCount, 0, 0, 0.0f});
+        return ranges;
+    }
+    if (!objData.lods.empty()) return objData.lods;
+    return {MeshLod{0, (uint32_t)objData.indices.size(), 0, 0, 0.0f}};
+}
+
+// f 레코드의 한 꼭짓점 (pi/ti/ni) - 용접(weld) 시 해시 키로 사용
+struct VertexKey {
+    unsigned int pi, ti, ni;
+    bool operator==(const VertexKey& o) const {
+        return pi == o.pi && ti == o.ti && ni == o.ni;
+    }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& k) const {
+        size_t h = k.pi * 73856093u;
+        h ^= k.ti * 19349663u + (h << 6) + (h >> 2);
+        h ^= k.ni * 83492791u + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+// ===== Memory-Mapped File (읽기 전용) =====
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& filename) {
+        Close();
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) { Close(); return false; }
+        size = (size_t)fileSize.QuadPart;
+        if (size == 0) return true;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) { Close(); return false; }
+        data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!data) { Close(); return false; }
+#else
+        fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) { Close(); return false; }
+        size = (size_t)st.st_size;
+        if (size == 0) return true;
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) { Close(); return false; }
+        data = (const char*)p;
+        madvise(p, size, MADV_SEQUENTIAL);
+#endif
+        return true;
+    }
+
+    void Close() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data) munmap((void*)data, size);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    const char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+// ===== Monotonic Arena =====
+// 로더의 임시 배열용. 블록 단위로 잡아 앞에서부터 잘라 주고, 개별 해제 없이 소멸자(또는
+// Reset)에서 한꺼번에 버린다. 필요한 양을 알면 첫 블록을 그 크기로 잡아 할당을 한 번으로 줄인다.
+// 스레드 안전하지 않으므로 병렬 구간 전에 미리 잡아 둔다.
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 1 << 20) : blockSize(blockSize) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // 초기화하지 않은 배열 (trivially copyable 타입만)
+    template <typename T>
+    T* Allocate(size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Arena holds raw arrays only");
+        return (T*)AllocateBytes(count * sizeof(T), alignof(T));
+    }
+
+    void* AllocateBytes(size_t size, size_t align) {
+        size_t offset = (blockUsed + align - 1) & ~(align - 1);
+        if (blocks.empty() || offset + size > blocks.back().size) {
+            size_t size0 = std::max(blockSize, size + align);
+            blocks.push_back({std::unique_ptr<char[]>(new char[size0]), size0});
+            offset = (size_t)(-(intptr_t)blocks.back().data.get() & (intptr_t)(align - 1));
+            reserved += size0;
+        }
+        blockUsed = offset + size;
+        used += size;
+        return blocks.back().data.get() + offset;
+    }
+
+    void Reset() {
+        blocks.clear();
+        blockUsed = 0;
+        used = 0;
+        reserved = 0;
+    }
+
+    size_t BytesUsed() const { return used; }
+    size_t BytesReserved() const { return reserved; }
+    size_t BlockCount() const { return blocks.size(); }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+    std::vector<Block> blocks;
+    size_t blockSize;
+    size_t blockUsed = 0;
+    size_t used = 0;
+    size_t reserved = 0;
+};
+
+// 용접용 열린 주소 해시 테이블. 노드 할당이 없고, 부하율이 1/2 을 넘으면 두 배 테이블을
+// arena 에서 새로 잡아 옮긴다 (옛 테이블은 arena 와 함께 버려진다).
+class VertexWeldTable {
+public:
+    VertexWeldTable(Arena& arena, size_t expected) : arena(arena) {
+        size_t capacity = 1024;
+        while (capacity < expected * 2) capacity *= 2;
+        Rehash(capacity);
+    }
+
+    // key 의 번호. 처음 보는 key 면 nextValue 를 주고 inserted = true.
+    unsigned int Insert(const VertexKey& key, unsigned int nextValue, bool& inserted) {
+        if ((count + 1) * 2 > mask + 1) Rehash((mask + 1) * 2);
+        size_t i = VertexKeyHash()(key) & mask;
+        for (;; i = (i + 1) & mask) {
+            Entry& e = entries[i];
+            if (e.value == kEmpty) {
+                e.key = key;
+                e.value = nextValue;
+                count++;
+                inserted = true;
+                return nextValue;
+            }
+            if (e.key == key) {
+                inserted = false;
+                return e.value;
+            }
+        }
+    }
+
+    // 슬롯 [begin, end) 에 들어 있는 (key, 번호) 마다 fn 호출. 구간을 나눠 병렬로 돌릴 수 있다.
+    template <typename Fn>
+    void ForEach(size_t begin, size_t end, Fn&& fn) const {
+        for (size_t i = begin; i < end; ++i)
+            if (entries[i].value != kEmpty) fn(entries[i].key, entries[i].value);
+    }
+
+    size_t Capacity() const { return mask + 1; }
+
+    size_t Size() const { return count; }
+
+private:
+    struct Entry {
+        VertexKey key;
+        unsigned int value;
+    };
+    static const unsigned int kEmpty = 0xFFFFFFFFu;
+
+    void Rehash(size_t capacity) {
+        Entry* old = entries;
+        size_t oldCapacity = entries ? mask + 1 : 0;
+        entries = arena.Allocate<Entry>(capacity);
+        mask = capacity - 1;
+        std::fill(entries, entries + capacity, Entry{{0, 0, 0}, kEmpty});
+        for (size_t i = 0; i < oldCapacity; ++i) {
+            if (old[i].value == kEmpty) continue;
+            size_t j = VertexKeyHash()(old[i].key) & mask;
+            while (entries[j].value != kEmpty) j = (j + 1) & mask;
+            entries[j] = old[i];
+        }
+    }
+
+    Arena& arena;
+    Entry* entries = nullptr;
+    size_t mask = 0;
+    size_t count = 0;
+};
+
+// ===== OBJ Tokenizer (포인터 기반, 라인 단위 할당 없음) =====
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline void skipBlanks(const char*& p, const char* end) {
+    while (p < end && isBlank(*p)) ++p;
+}
+
+// 공백으로 구분된 다음 토큰 [p, 반환값) 의 끝을 찾는다
+inline const char* tokenEnd(const char* p, const char* end) {
+    while (p < end && !isBlank(*p)) ++p;
+    return p;
+}
+
+// 앞뒤 공백을 뺀 나머지 줄 (파일 이름처럼 공백이 들어갈 수 있는 값)
+inline std::string restOfLine(const char* p, const char* end) {
+    skipBlanks(p, end);
+    while (end > p && isBlank(end[-1])) --end;
+    return std::string(p, end);
+}
+
+inline float parseFloat(const char*& p, const char* end) {
+    skipBlanks(p, end);
+    if (p < end && *p == '+') ++p;
+    float value = 0.0f;
+    auto result = std::from_chars(p, end, value);
+    p = result.ptr;
+    return value;
+}
+
+// "12" 처럼 1-based 인덱스를 읽어 0-based로 반환 (숫자가 없으면 0)
+inline unsigned int parseIndex(const char*& p, const char* end) {
+    unsigned int value = 0;
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return 0;
+    p = result.ptr;
+    return value - 1;
+}
+
+// ===== OBJ Chunk Parser =====
+// v 레코드를 읽는 즉시 AABB 를 누적한다 (SSE min/max). 청크마다 따로 모아 Merge 로 합치므로
+// 결과가 청크(스레드) 수와 무관하다. 바운딩 구는 합친 AABB 의 중심을 쓰고 반지름은
+// 위치 배열을 한 번 더 훑어 정확히 구한다 (maxDistance).
+struct BoundsAccumulator {
+#ifdef HAS_SSE
+    __m128 lo = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    __m128 hi = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+#else
+    glm::vec3 lo{std::numeric_limits<float>::infinity()};
+    glm::vec3 hi{-std::numeric_limits<float>::infinity()};
+#endif
+
+    void Add(const glm::vec3& p) {
+#ifdef HAS_SSE
+        __m128 v = _mm_set_ps(0.0f, p.z, p.y, p.x);
+        lo = _mm_min_ps(lo, v);
+        hi = _mm_max_ps(hi, v);
+#else
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+#endif
+    }
+
+    void Merge(const BoundsAccumulator& o) {
+#ifdef HAS_SSE
+        lo = _mm_min_ps(lo, o.lo);
+        hi = _mm_max_ps(hi, o.hi);
+#else
+        lo = glm::min(lo, o.lo);
+        hi = glm::max(hi, o.hi);
+#endif
+    }
+
+    bool Empty() const { return Min().x > Max().x; }
+
+    glm::vec3 Center() const { return (Min() + Max()) * 0.5f; }
+
+    // AABB 를 감싸는 구의 반지름 (모든 점을 포함하는 반지름의 상한)
+    float HalfDiagonal() const { return glm::length(Max() - Min()) * 0.5f; }
+
+    glm::vec3 Min() const {
+#ifdef HAS_SSE
+        float v[4];
+        _mm_storeu_ps(v, lo);
+        return glm::vec3(v[0], v[1], v[2]);
+#else
+        return lo;
+#endif
+    }
+
+    glm::vec3 Max() const {
+#ifdef HAS_SSE
+        float v[4];
+        _mm_storeu_ps(v, hi);
+        return glm::vec3(v[0], v[1], v[2]);
+#else
+        return hi;
+#endif
+    }
+};
+
+// 파일의 한 구간(라인 경계로 잘린)을 파싱한 결과. 면 인덱스는 파일 전체 기준이라
+// 정점 조립은 모든 청크가 끝난 뒤 병합 단계에서 한다.
+// countOBJChunk() 로 레코드 수를 먼저 세고, 그 크기대로 잡아 둔 배열 (보통 파일 전체
+// 배열에서 이 청크 몫의 구간) 에 parseOBJChunk() 가 바로 쓴다.
+struct ObjChunk {
+    size_t positionCount = 0;
+    size_t normalCount = 0;
+    size_t texcoordCount = 0;
+    size_t cornerCount = 0;         // 삼각형마다 3개
+    glm::vec3* positions = nullptr;
+    glm::vec3* normals = nullptr;
+    glm::vec2* texcoords = nullptr;
+    VertexKey* corners = nullptr;   // 0-based pi/ti/ni
+    BoundsAccumulator bounds;
+
+    // 드물게 나오는 레코드라 그냥 문자열로 모은다
+    std::vector<std::string> materialLibraries;  // mtllib
+    std::vector<std::pair<size_t, std::string>> materialSwitches; // (청크 안 코너 번호, usemtl 이름)
+};
+
+enum class ObjRecord { Other, Position, Normal, Texcoord, Face, MaterialLibrary, UseMaterial };
+
+// 라인 첫 토큰으로 레코드 종류를 정하고 p 를 그 토큰 뒤로 옮긴다 (세기/파싱이 같은 규칙을 쓴다)
+inline ObjRecord objRecord(const char*& p, const char* lineEnd) {
+    skipBlanks(p, lineEnd);
+    const char* prefixEnd = tokenEnd(p, lineEnd);
+    size_t prefixLen = (size_t)(prefixEnd - p);
+    ObjRecord record = ObjRecord::Other;
+    if (prefixLen == 1 && p[0] == 'v') record = ObjRecord::Position;
+    else if (prefixLen == 2 && p[0] == 'v' && p[1] == 'n') record = ObjRecord::Normal;
+    else if (prefixLen == 2 && p[0] == 'v' && p[1] == 't') record = ObjRecord::Texcoord;
+    else if (prefixLen == 1 && p[0] == 'f') record = ObjRecord::Face;
+    else if (prefixLen == 6 && memcmp(p, "mtllib", 6) == 0) record = ObjRecord::MaterialLibrary;
+    else if (prefixLen == 6 && memcmp(p, "usemtl", 6) == 0) record = ObjRecord::UseMaterial;
+    p = prefixEnd;
+    return record;
+}
+
+// 숫자는 읽지 않고 memchr 로 줄만 넘기며 레코드 수만 센다
+void countOBJChunk(const char* p, const char* end, ObjChunk& chunk) {
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', (size_t)(end - p));
+        if (!lineEnd) lineEnd = end;
+        switch (objRecord(p, lineEnd)) {
+        case ObjRecord::Position: chunk.positionCount++; break;
+        case ObjRecord::Normal:   chunk.normalCount++; break;
+        case ObjRecord::Texcoord: chunk.texcoordCount++; break;
+        case ObjRecord::Face:     chunk.cornerCount += 3; break;
+        default: break;
+        }
+        p = lineEnd + 1;
+    }
+}
+
+// 청크들의 개수를 합쳐 파일 전체 배열을 arena 에서 한 번씩 잡고, 청크마다 자기 구간을 가리키게 한다
+struct ObjArrays {
+    size_t positionCount = 0, normalCount = 0, texcoordCount = 0, cornerCount = 0;
+    glm::vec3* positions = nullptr;
+    glm::vec3* normals = nullptr;
+    glm::vec2* texcoords = nullptr;
+    VertexKey* corners = nullptr;
+};
+
+ObjArrays allocateOBJChunks(std::vector<ObjChunk>& chunks, Arena& arena) {
+    ObjArrays arrays;
+    for (const ObjChunk& c : chunks) {
+        arrays.positionCount += c.positionCount;
+        arrays.normalCount += c.normalCount;
+        arrays.texcoordCount += c.texcoordCount;
+        arrays.cornerCount += c.cornerCount;
+    }
+    arrays.positions = arena.Allocate<glm::vec3>(arrays.positionCount);
+    arrays.normals = arena.Allocate<glm::vec3>(arrays.normalCount);
+    arrays.texcoords = arena.Allocate<glm::vec2>(arrays.texcoordCount);
+    arrays.corners = arena.Allocate<VertexKey>(arrays.cornerCount);
+
+    size_t positions = 0, normals = 0, texcoords = 0, corners = 0;
+    for (ObjChunk& c : chunks) {
+        c.positions = arrays.positions + positions;
+        c.normals = arrays.normals + normals;
+        c.texcoords = arrays.texcoords + texcoords;
+        c.corners = arrays.corners + corners;
+        positions += c.positionCount;
+        normals += c.normalCount;
+        texcoords += c.texcoordCount;
+        corners += c.cornerCount;
+    }
+    return arrays;
+}
+
+// countOBJChunk() 가 잰 배열 크기를 그대로 채우는 데 필요한 바이트 (정렬 여유 포함)
+size_t objArrayBytes(const std::vector<ObjChunk>& chunks) {
+    size_t bytes = 64;
+    for (const ObjChunk& c : chunks)
+        bytes += c.positionCount * sizeof(glm::vec3) + c.normalCount * sizeof(glm::vec3) +
+                 c.texcoordCount * sizeof(glm::vec2) + c.cornerCount * sizeof(VertexKey);
+    return bytes;
+}
+
+// "pi", "pi/ti", "pi//ni", "pi/ti/ni" 토큰 하나를 읽는다
+inline VertexKey parseCorner(const char*& p, const char* end) {
+    skipBlanks(p, end);
+    const char* tokEnd = tokenEnd(p, end);
+    VertexKey key{parseIndex(p, tokEnd), 0, 0};
+    if (p < tokEnd && *p == '/') {
+        ++p;
+        if (p < tokEnd && *p != '/')
+            key.ti = parseIndex(p, tokEnd);
+        if (p < tokEnd && *p == '/') {
+            ++p;
+            key.ni = parseIndex(p, tokEnd);
+        }
+    }
+    p = tokEnd;
+    return key;
+}
+
+void parseOBJChunk(const char* p, const char* end, ObjChunk& chunk) {
+    size_t positions = 0, normals = 0, texcoords = 0, corners = 0;
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', (size_t)(end - p));
+        if (!lineEnd) lineEnd = end;
+
+        switch (objRecord(p, lineEnd)) {
+        case ObjRecord::Position: {
+            glm::vec3 v;
+            v.x = parseFloat(p, lineEnd);
+            v.y = parseFloat(p, lineEnd);
+            v.z = parseFloat(p, lineEnd);
+            chunk.positions[positions++] = v;
+            chunk.bounds.Add(v);
+            break;
+        }
+        case ObjRecord::Normal: {
+            glm::vec3 n;
+            n.x = parseFloat(p, lineEnd);
+            n.y = parseFloat(p, lineEnd);
+            n.z = parseFloat(p, lineEnd);
+            chunk.normals[normals++] = n;
+            break;
+        }
+        case ObjRecord::Texcoord: {
+            glm::vec2 t;
+            t.x = parseFloat(p, lineEnd);
+            t.y = parseFloat(p, lineEnd);
+            chunk.texcoords[texcoords++] = t;
+            break;
+        }
+        case ObjRecord::Face:
+            chunk.corners[corners++] = parseCorner(p, lineEnd);
+            chunk.corners[corners++] = parseCorner(p, lineEnd);
+            chunk.corners[corners++] = parseCorner(p, lineEnd);
+            break;
+        case ObjRecord::MaterialLibrary:
+            chunk.materialLibraries.push_back(restOfLine(p, lineEnd));
+            break;
+        case ObjRecord::UseMaterial:
+            chunk.materialSwitches.push_back({corners, restOfLine(p, lineEnd)});
+            break;
+        default:
+            break;
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+// 청크 하나당 최소 크기. 이보다 작은 파일은 스레드 생성 비용이 더 크다.
+const size_t kMinOBJChunkBytes = 1 << 20;
+
+// fn(i)를 [0, count) 에 대해 count개의 스레드로 실행 (count가 1이면 호출 스레드에서)
+template <typename Fn>
+void runParallel(size_t count, Fn&& fn) {
+    if (count <= 1) {
+        if (count == 1) fn((size_t)0);
+        return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(count - 1);
+    for (size_t i = 1; i < count; ++i)
+        workers.emplace_back([&fn, i] { fn(i); });
+    fn((size_t)0);
+    for (auto& t : workers) t.join();
+}
+
+// [0, count) 를 코어 수만큼의 연속 구간으로 나눠 fn(begin, end) 를 병렬 실행한다.
+// 구간 하나가 minGrain 보다 작아지지 않도록 스레드 수를 줄인다.
+template <typename Fn>
+void parallelRanges(size_t count, size_t minGrain, Fn&& fn) {
+    size_t workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = std::max<size_t>(1, std::min(workerCount, count / std::max<size_t>(minGrain, 1)));
+    runParallel(workerCount, [&](size_t i) {
+        fn(count * i / workerCount, count * (i + 1) / workerCount);
+    });
+}
+
+// center 에서 가장 먼 점까지의 거리 (점이 없으면 0). 바운딩 구 반지름용.
+float maxDistance(const glm::vec3* points, size_t count, const glm::vec3& center) {
+    float maxDist2 = 0.0f;
+    std::mutex mutex;
+    parallelRanges(count, 1 << 16, [&](size_t begin, size_t end) {
+        float local = 0.0f;
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 d = points[i] - center;
+            local = std::max(local, glm::dot(d, d));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        maxDist2 = std::max(maxDist2, local);
+    });
+    return std::sqrt(maxDist2) * (1.0f + 1e-6f); // 반올림으로 점이 살짝 밖에 남지 않도록
+}
+
+// ===== Smooth Normal Generation =====
+// vn 이 없는 OBJ 용. 면 법선을 면적 x 코너 각도로 가중해 같은 위치의 코너끼리 합치되,
+// 면 법선 사이 각이 creaseAngle 을 넘는 면은 섞지 않는다 (모서리는 날카롭게 유지).
+struct PositionHash {
+    size_t operator()(const glm::vec3& p) const {
+        uint32_t bits[3];
+        memcpy(bits, &p, sizeof(bits));
+        return VertexKeyHash()(VertexKey{bits[0], bits[1], bits[2]});
+    }
+};
+
+// 위치의 비트 패턴을 용접 키로 (-0 은 +0 으로 맞춘다)
+inline VertexKey positionBits(const glm::vec3& p) {
+    glm::vec3 q = p + glm::vec3(0.0f);
+    uint32_t bits[3];
+    memcpy(bits, &q, sizeof(bits));
+    return VertexKey{bits[0], bits[1], bits[2]};
+}
+
+void generateNormals(ObjData& objData, float creaseAngle = 60.0f) {
+    auto startTime = std::chrono::steady_clock::now();
+    const std::vector<unsigned int>& indices = objData.indices;
+    size_t cornerCount = indices.size();
+    size_t triCount = cornerCount / 3;
+    size_t vertexCount = objData.vertices.size();
+    if (triCount == 0) return;
+
+    // 1) 삼각형 단위 병렬: 단위 면 법선과 코너별 가중 법선 (면적 x 각도)
+    std::vector<glm::vec3> faceNormal(triCount);
+    std::vector<glm::vec3> cornerWeighted(cornerCount);
+    parallelRanges(triCount, 4096, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const glm::vec3& a = objData.vertices[indices[t * 3]].pos;
+            const glm::vec3& b = objData.vertices[indices[t * 3 + 1]].pos;
+            const glm::vec3& c = objData.vertices[indices[t * 3 + 2]].pos;
+            glm::vec3 n = glm::cross(b - a, c - a);   // 길이 = 면적 x 2
+            float len = glm::length(n);
+            faceNormal[t] = len > 0.0f ? n / len : glm::vec3(0.0f);
+
+            const glm::vec3* p[3] = {&a, &b, &c};
+            for (int k = 0; k < 3; ++k) {
+                glm::vec3 e1 = *p[(k + 1) % 3] - *p[k];
+                glm::vec3 e2 = *p[(k + 2) % 3] - *p[k];
+                float l1 = glm::length(e1), l2 = glm::length(e2);
+                float angle = 0.0f;
+                if (l1 > 0.0f && l2 > 0.0f)
+                    angle = std::acos(std::max(-1.0f, std::min(1.0f, glm::dot(e1, e2) / (l1 * l2))));
+                cornerWeighted[t * 3 + k] = n * angle;
+            }
+        }
+    });
+
+    // 2) 같은 위치를 공유하는 정점 묶기 (UV 이음새로 갈라진 정점도 매끄럽게 이어지도록).
+    //    열린 주소 테이블 (노드 할당 없음) 의 칸에는 그 위치를 처음 가진 정점 번호만 두고,
+    //    키는 그 정점의 위치에서 다시 읽는다 (칸당 4 바이트).
+    const unsigned int kUnassigned = 0xFFFFFFFFu;
+    std::vector<unsigned int> groupOf(vertexCount);
+    unsigned int groupCount = 0;
+    {
+        size_t capacity = 1024;
+        while (capacity < vertexCount * 2) capacity *= 2;
+        size_t mask = capacity - 1;
+        std::vector<unsigned int> firstAt(capacity, kUnassigned);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            VertexKey key = positionBits(objData.vertices[v].pos);
+            for (size_t i = VertexKeyHash()(key) & mask;; i = (i + 1) & mask) {
+                unsigned int first = firstAt[i];
+                if (first == kUnassigned) {
+                    firstAt[i] = (unsigned int)v;
+                    groupOf[v] = groupCount++;
+                    break;
+                }
+                if (positionBits(objData.vertices[first].pos) == key) {
+                    groupOf[v] = groupOf[first];
+                    break;
+                }
+            }
+        }
+    }
+
+    // 위치 그룹 -> 코너 목록 (CSR, 코너 번호 오름차순이라 합산 순서가 결정적)
+    std::vector<unsigned int> groupOffset(groupCount + 1, 0);
+    for (size_t c = 0; c < cornerCount; ++c) groupOffset[groupOf[indices[c]] + 1]++;
+    for (size_t g = 0; g < groupCount; ++g) groupOffset[g + 1] += groupOffset[g];
+    std::vector<unsigned int> groupCorners(cornerCount);
+    {
+        std::vector<unsigned int> fill(groupOffset.begin(), groupOffset.end() - 1);
+        for (size_t c = 0; c < cornerCount; ++c)
+            groupCorners[fill[groupOf[indices[c]]]++] = (unsigned int)c;
+    }
+
+    // 3) 코너 단위 병렬 gather: 크리스 각 안쪽의 면만 더한다. 각 코너가 자기 결과만 쓰므로 락이 없다.
+    float cosCrease = std::cos(glm::radians(creaseAngle));
+    std::vector<glm::vec3> cornerNormal(cornerCount);
+    parallelRanges(cornerCount, 8192, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            const glm::vec3& fn = faceNormal[c / 3];
+            bool degenerate = fn == glm::vec3(0.0f); // 넓이 0 인 면은 주변 법선을 그대로 따른다
+            unsigned int g = groupOf[indices[c]];
+            glm::vec3 sum(0.0f);
+            for (unsigned int i = groupOffset[g]; i < groupOffset[g + 1]; ++i) {
+                unsigned int other = groupCorners[i];
+                if (degenerate || glm::dot(faceNormal[other / 3], fn) >= cosCrease)
+                    sum += cornerWeighted[other];
+            }
+            float len = glm::length(sum);
+            if (len > 0.0f)
+                cornerNormal[c] = sum / len;
+            else if (!degenerate)
+                cornerNormal[c] = fn;
+            else
+                cornerNormal[c] = glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    });
+
+    // 4) 코너마다 (원래 정점, 법선) 으로 다시 용접. 크리스에 걸린 정점만 갈라진다.
+    //    정점 -> 코너 목록 (CSR) 을 만들고, 정점 단위 병렬로 목록을 (법선 비트, 코너) 순으로 정렬해
+    //    같은 법선의 가장 앞 코너 (대표) 를 찾는다 (해시 없음). 번호는 코너 순서대로 대표에게만
+    //    차례로 준다 (처음 나온 (정점, 법선) 순이라 정점 순서는 결정적이다).
+    std::vector<unsigned int> vertexOffset(vertexCount + 1, 0);
+    for (size_t c = 0; c < cornerCount; ++c) vertexOffset[indices[c] + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v) vertexOffset[v + 1] += vertexOffset[v];
+    std::vector<unsigned int> vertexCorners(cornerCount);
+    {
+        std::vector<unsigned int> fill(vertexOffset.begin(), vertexOffset.end() - 1);
+        for (size_t c = 0; c < cornerCount; ++c)
+            vertexCorners[fill[indices[c]]++] = (unsigned int)c;
+    }
+
+    std::vector<unsigned int> representative(cornerCount);
+    parallelRanges(vertexCount, 4096, [&](size_t begin, size_t end) {
+        auto before = [&](unsigned int a, unsigned int b) {
+            VertexKey ka = positionBits(cornerNormal[a]), kb = positionBits(cornerNormal[b]);
+            if (ka.pi != kb.pi) return ka.pi < kb.pi;
+            if (ka.ti != kb.ti) return ka.ti < kb.ti;
+            if (ka.ni != kb.ni) return ka.ni < kb.ni;
+            return a < b;
+        };
+        for (size_t v = begin; v < end; ++v) {
+            unsigned int* first = vertexCorners.data() + vertexOffset[v];
+            unsigned int* last = vertexCorners.data() + vertexOffset[v + 1];
+            std::sort(first, last, before);
+            for (unsigned int* it = first; it < last; ++it)
+                representative[*it] = it > first && positionBits(cornerNormal[it[-1]]) == positionBits(cornerNormal[*it])
+                                          ? representative[it[-1]] : *it;
+        }
+    });
+
+    std::vector<unsigned int> newIndices(cornerCount);
+    unsigned int newVertexCount = 0;
+    for (size_t c = 0; c < cornerCount; ++c)
+        newIndices[c] = representative[c] == c ? newVertexCount++ : newIndices[representative[c]];
+
+    std::vector<Vertex> vertices(newVertexCount);
+    parallelRanges(cornerCount, 8192, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            if (representative[c] != c) continue;
+            Vertex& vertex = vertices[newIndices[c]];
+            vertex = objData.vertices[indices[c]];
+            vertex.nor = cornerNormal[c];
+        }
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Generated normals: " << vertexCount << " -> " << vertices.size()
+              << " vertices (crease " << creaseAngle << " deg, " << seconds * 1000.0 << " ms)\n";
+
+    objData.vertices.swap(vertices);
+    objData.indices.swap(newIndices);
+}
+
+// ===== MTL Materials =====
+// newmtl / Kd / map_Kd 만 읽는다. 텍스처 경로는 MTL 파일 위치 기준, MTL 경로는 OBJ 위치 기준.
+std::string resolveAssetPath(const std::string& baseFile, std::string path) {
+    std::replace(path.begin(), path.end(), '\\', '/');
+    std::filesystem::path relative(path);
+    if (relative.is_absolute()) return path;
+    return (std::filesystem::path(baseFile).parent_path() / relative).lexically_normal().string();
+}
+
+// 같은 이름이 이미 있으면 덮어쓴다
+bool loadMTL(const std::string& filename, std::vector<Material>& materials,
+             std::unordered_map<std::string, uint32_t>& byName) {
+    MappedFile file;
+    if (!file.Open(filename)) return false;
+    const char* p = file.Data();
+    const char* end = p + file.Size();
+    Material* current = nullptr; // push_back 은 newmtl 에서만 하고 바로 다시 잡는다
+    while (p < end) {
+        const char* lineEnd = (const char*)memchr(p, '\n', (size_t)(end - p));
+        if (!lineEnd) lineEnd = end;
+        skipBlanks(p, lineEnd);
+        const char* keyEnd = tokenEnd(p, lineEnd);
+        std::string key(p, keyEnd);
+        p = keyEnd;
+
+        if (key == "newmtl") {
+            std::string name = restOfLine(p, lineEnd);
+            auto inserted = byName.emplace(name, (uint32_t)materials.size());
+            if (inserted.second) materials.push_back(Material{name, glm::vec3(1.0f), std::string()});
+            current = &materials[inserted.first->second];
+            *current = Material{name, glm::vec3(1.0f), std::string()};
+        } else if (current && key == "Kd") {
+            current->diffuse.r = parseFloat(p, lineEnd);
+            current->diffuse.g = parseFloat(p, lineEnd);
+            current->diffuse.b = parseFloat(p, lineEnd);
+        } else if (current && key == "map_Kd") {
+            // "-s 1 1 1 file.png" 같은 옵션이 있으면 마지막 토큰만 파일 이름으로 본다
+            std::string value = restOfLine(p, lineEnd);
+            if (!value.empty() && value[0] == '-') {
+                size_t space = value.find_last_of(" \t");
+                if (space != std::string::npos) value = value.substr(space + 1);
+            }
+            if (!value.empty()) current->diffuseMap = resolveAssetPath(filename, value);
+        }
+        p = lineEnd + 1;
+    }
+    return true;
+}
+
+// usemtl 구간대로 삼각형마다 재질을 정하고, 재질별로 삼각형을 모아 objData.indices 를 다시 쓴다.
+// 재질은 (텍스처, 이름) 순으로 놓아 같은 텍스처를 쓰는 submesh 가 이어지게 한다.
+// 첫 usemtl 앞의 면이나 MTL 에 없는 이름은 흰색 기본 재질로.
+void groupByMaterial(ObjData& objData, const std::vector<ObjChunk>& chunks, const std::string& objPath) {
+    objData.materials.clear();
+    objData.submeshes.clear();
+    bool used = false;
+    for (const ObjChunk& chunk : chunks)
+        used |= !chunk.materialSwitches.empty();
+    if (!used) return;
+
+    std::unordered_map<std::string, uint32_t> byName;
+    for (const ObjChunk& chunk : chunks) {
+        for (const std::string& library : chunk.materialLibraries) {
+            std::string path = resolveAssetPath(objPath, library);
+            if (!loadMTL(path, objData.materials, byName))
+                std::cout << "Could not read material library " << path << "\n";
+        }
+    }
+    auto materialIndex = [&](const std::string& name) {
+        auto inserted = byName.emplace(name, (uint32_t)objData.materials.size());
+        if (inserted.second) objData.materials.push_back(Material{name, glm::vec3(1.0f), std::string()});
+        return inserted.first->second;
+    };
+
+    // 코너 순서 = 파일 순서 = objData.indices 순서
+    size_t triangleCount = objData.indices.size() / 3;
+    std::vector<uint32_t> triangleMaterial(triangleCount);
+    const uint32_t kUnset = 0xFFFFFFFFu;
+    uint32_t current = kUnset;
+    size_t tri = 0, cornerBase = 0;
+    auto fillUntil = [&](size_t corner) {
+        size_t endTri = std::min(triangleCount, corner / 3);
+        if (tri < endTri && current == kUnset) current = materialIndex("");
+        for (; tri < endTri; ++tri) triangleMaterial[tri] = current;
+    };
+    for (const ObjChunk& chunk : chunks) {
+        for (const auto& change : chunk.materialSwitches) {
+            fillUntil(cornerBase + change.first);
+            current = materialIndex(change.second);
+        }
+        cornerBase += chunk.cornerCount;
+    }
+    fillUntil(cornerBase);
+
+    std::vector<uint32_t> order(objData.materials.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const Material& ma = objData.materials[a];
+        const Material& mb = objData.materials[b];
+        return ma.diffuseMap != mb.diffuseMap ? ma.diffuseMap < mb.diffuseMap : ma.name < mb.name;
+    });
+
+    // 재질 순서로 안정 계수 정렬
+    std::vector<uint32_t> offset(objData.materials.size() + 1, 0);
+    std::vector<uint32_t> rank(objData.materials.size());
+    for (uint32_t r = 0; r < order.size(); ++r) rank[order[r]] = r;
+    for (uint32_t m : triangleMaterial) offset[rank[m] + 1]++;
+    for (size_t r = 0; r < order.size(); ++r) offset[r + 1] += offset[r];
+    for (uint32_t r = 0; r < order.size(); ++r) {
+        if (offset[r + 1] > offset[r])
+            objData.submeshes.push_back({offset[r] * 3, (offset[r + 1] - offset[r]) * 3, order[r]});
+    }
+    std::vector<unsigned int> indices(objData.indices.size());
+    for (size_t t = 0; t < triangleCount; ++t) {
+        uint32_t dst = offset[rank[triangleMaterial[t]]]++;
+        std::copy_n(&objData.indices[t * 3], 3, &indices[(size_t)dst * 3]);
+    }
+    objData.indices.swap(indices);
+
+    size_t textured = 0;
+    for (const Material& m : objData.materials) textured += !m.diffuseMap.empty();
+    std::cout << "  Materials: " << objData.materials.size() << " (" << textured << " textured), "
+              << objData.submeshes.size() << " submeshes\n";
+}
+
+// ===== Compressed OBJ Input (.obj.gz) =====
+// 압축된 OBJ 를 임시 파일 없이 읽는다. 압축 해제 스레드가 풀린 텍스트를 줄 경계에서 창 단위로
+// 잘라 큐에 넣고, 파서 스레드들이 창마다 세기/파싱을 한다. 풀린 텍스트 전체는 메모리에 두지 않는다.
+// 허프만 테이블/비트 읽기는 stb_image 의 zlib 구현(같은 번역 단위)을 그대로 쓰고, stb 가 출력 전체를
+// 한 버퍼로 키우는 부분만 32KB 히스토리를 남기고 밀어내는 고정 버퍼로 바꿨다.
+const size_t kInflateHistoryBytes = 32 * 1024;  // DEFLATE 최대 거리
+const size_t kInflateFlushBytes = 1 << 20;      // 출력이 이만큼 쌓이면 내보낸다
+const size_t kObjWindowBytes = 4 << 20;         // 파서에 넘기는 창 크기 (줄 경계까지 늘어난다)
+const size_t kObjMaxQueuedWindows = 8;
+
+enum class ObjCompression { None, Gzip, Zstd };
+
+// 확장자 대신 매직 바이트로 판단한다
+ObjCompression objCompression(const char* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    if (size >= 2 && p[0] == 0x1F && p[1] == 0x8B) return ObjCompression::Gzip;
+    if (size >= 4 && p[0] == 0x28 && p[1] == 0xB5 && p[2] == 0x2F && p[3] == 0xFD) return ObjCompression::Zstd;
+    return ObjCompression::None;
+}
+
+// gzip 스트림(이어 붙인 여러 멤버 포함)을 풀면서 sink(data, size) 로 조금씩 내보낸다.
+// sink 가 false 를 돌려주면 중단한다. CRC 는 검사하지 않고 멤버 길이(ISIZE)만 맞춰 본다.
+class GzipInflater {
+public:
+    GzipInflater(const char* data, size_t size)
+        : input((const stbi_uc*)data), inputEnd((const stbi_uc*)data + size) {}
+
+    template <typename Sink>
+    bool Run(Sink&& sink) {
+        buffer.resize(kInflateHistoryBytes + kInflateFlushBytes);
+        const stbi_uc* p = input;
+        do {
+            if (!ParseHeader(p)) return false;
+            uint64_t memberStart = Produced();
+            if (!InflateMember(p, sink)) return false;
+            if (inputEnd - p < 8) return Fail("truncated gzip trailer");
+            uint32_t size = (uint32_t)p[4] | (uint32_t)p[5] << 8 | (uint32_t)p[6] << 16 | (uint32_t)p[7] << 24;
+            if (size != (uint32_t)(Produced() - memberStart)) return Fail("gzip length mismatch");
+            p += 8;
+            while (p < inputEnd && *p == 0) ++p; // 끝의 0 채움은 허용
+        } while (p < inputEnd);
+        return Flush(sink);
+    }
+
+    const char* Error() const { return error; }
+    uint64_t Produced() const { return flushedTotal + (out - flushed); }
+
+private:
+    bool Fail(const char* message) {
+        error = message;
+        return false;
+    }
+
+    bool ParseHeader(const stbi_uc*& p) {
+        if (inputEnd - p < 10 || p[0] != 0x1F || p[1] != 0x8B) return Fail("not a gzip stream");
+        if (p[2] != 8) return Fail("unsupported gzip compression method");
+        int flags = p[3];
+        p += 10;
+        if (flags & 4) { // FEXTRA
+            if (inputEnd - p < 2) return Fail("truncated gzip header");
+            size_t extra = p[0] | p[1] << 8;
+            p += 2;
+            if ((size_t)(inputEnd - p) < extra) return Fail("truncated gzip header");
+            p += extra;
+        }
+        for (int field = 8; field <= 16; field *= 2) { // FNAME, FCOMMENT (0 으로 끝나는 문자열)
+            if (!(flags & field)) continue;
+            while (p < inputEnd && *p) ++p;
+            if (p == inputEnd) return Fail("truncated gzip header");
+            ++p;
+        }
+        if (flags & 2) p += 2; // FHCRC
+        if (p > inputEnd) return Fail("truncated gzip header");
+        return true;
+    }
+
+    // 쌓인 출력을 내보내고 마지막 32KB 만 히스토리로 남긴다
+    template <typename Sink>
+    bool Flush(Sink& sink) {
+        if (out > flushed && !sink(buffer.data() + flushed, out - flushed)) return Fail("cancelled");
+        flushedTotal += out - flushed;
+        size_t keep = std::min(out, kInflateHistoryBytes);
+        memmove(buffer.data(), buffer.data() + out - keep, keep);
+        out = flushed = keep;
+        return true;
+    }
+
+    // stbi__parse_zlib 와 같은 블록 루프, 출력만 고정 버퍼로
+    template <typename Sink>
+    bool InflateMember(const stbi_uc*& p, Sink& sink) {
+        z = stbi__zbuf{};
+        z.zbuffer = (stbi_uc*)p;
+        z.zbuffer_end = (stbi_uc*)inputEnd;
+        int final;
+        do {
+            final = stbi__zreceive(&z, 1);
+            int type = stbi__zreceive(&z, 2);
+            bool ok;
+            if (type == 0) {
+                ok = StoredBlock(sink);
+            } else if (type == 3) {
+                ok = Fail("bad deflate block type");
+            } else {
+                if (type == 1)
+                    ok = stbi__zbuild_huffman(&z.z_length, stbi__zdefault_length, STBI__ZNSYMS) &&
+                         stbi__zbuild_huffman(&z.z_distance, stbi__zdefault_distance, 32);
+                else
+                    ok = stbi__compute_huffman_codes(&z);
+                ok = ok ? HuffmanBlock(sink) : Fail("bad huffman table");
+            }
+            if (!ok) return false;
+        } while (!final);
+
+        // 비트 버퍼에 미리 읽어 둔 바이트를 되돌려 트레일러 위치를 찾는다
+        if (z.hit_zeof_once) return Fail("truncated deflate stream");
+        stbi__zreceive(&z, z.num_bits & 7);
+        p = z.zbuffer - z.num_bits / 8;
+        return true;
+    }
+
+    template <typename Sink>
+    bool HuffmanBlock(Sink& sink) {
+        for (;;) {
+            if (out + 258 > buffer.size() && !Flush(sink)) return false; // 최대 일치 길이만큼 여유
+            int symbol = stbi__zhuffman_decode(&z, &z.z_length);
+            if (symbol < 256) {
+                if (symbol < 0) return Fail("bad huffman code");
+                buffer[out++] = (char)symbol;
+                continue;
+            }
+            if (symbol == 256) {
+                if (z.hit_zeof_once && z.num_bits < 16) return Fail("truncated deflate stream");
+                return true;
+            }
+            if (symbol >= 286) return Fail("bad huffman code");
+            symbol -= 257;
+            size_t length = stbi__zlength_base[symbol];
+            if (stbi__zlength_extra[symbol]) length += stbi__zreceive(&z, stbi__zlength_extra[symbol]);
+            int code = stbi__zhuffman_decode(&z, &z.z_distance);
+            if (code < 0 || code >= 30) return Fail("bad huffman code");
+            size_t distance = stbi__zdist_base[code];
+            if (stbi__zdist_extra[code]) distance += stbi__zreceive(&z, stbi__zdist_extra[code]);
+            if (distance > out) return Fail("bad deflate distance");
+
+            char* dst = buffer.data() + out;
+            const char* src = dst - distance;
+            if (distance >= length) {
+                memcpy(dst, src, length);
+            } else {
+                for (size_t i = 0; i < length; ++i) dst[i] = src[i]; // 겹치는 복사 (반복 패턴)
+            }
+            out += length;
+        }
+    }
+
+    template <typename Sink>
+    bool StoredBlock(Sink& sink) {
+        stbi__zreceive(&z, z.num_bits & 7);
+        stbi_uc header[4];
+        int k = 0;
+        while (z.num_bits > 0 && k < 4) {
+            header[k++] = (stbi_uc)(z.code_buffer & 255);
+            z.code_buffer >>= 8;
+            z.num_bits -= 8;
+        }
+        while (k < 4) header[k++] = stbi__zget8(&z);
+        size_t length = header[0] | header[1] << 8;
+        size_t inverted = header[2] | header[3] << 8;
+        if (inverted != (length ^ 0xFFFF)) return Fail("corrupt stored block");
+        if ((size_t)(z.zbuffer_end - z.zbuffer) < length) return Fail("truncated stored block");
+        while (length > 0) {
+            if (out == buffer.size() && !Flush(sink)) return false;
+            size_t n = std::min(length, buffer.size() - out);
+            memcpy(buffer.data() + out, z.zbuffer, n);
+            z.zbuffer += n;
+            out += n;
+            length -= n;
+        }
+        return true;
+    }
+
+    const stbi_uc* input;
+    const stbi_uc* inputEnd;
+    stbi__zbuf z{};
+    std::vector<char> buffer;   // [히스토리 | 아직 안 내보낸 출력]
+    size_t out = 0;             // 다음에 쓸 위치
+    size_t flushed = 0;         // 여기까지 내보냄
+    uint64_t flushedTotal = 0;
+    const char* error = nullptr;
+};
+
+// 줄 경계에서 자른 텍스트 조각. index 는 파일 안 순서.
+struct ObjTextWindow {
+    size_t index = 0;
+    std::vector<char> text;
+};
+
+// 압축 해제 스레드 하나 -> 파서 스레드 여럿
+class ObjWindowQueue {
+public:
+    // 큐가 차 있으면 기다린다. 파서 쪽이 Cancel() 했으면 false.
+    bool Push(ObjTextWindow&& window) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return windows.size() < kObjMaxQueuedWindows || cancelled; });
+        if (cancelled) return false;
+        windows.push_back(std::move(window));
+        changed.notify_all();
+        return true;
+    }
+
+    // 비어 있으면 기다린다. 생산자가 끝났고 다 꺼냈으면 false.
+    bool Pop(ObjTextWindow& window) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return !windows.empty() || closed || cancelled; });
+        if (windows.empty() || cancelled) return false;
+        window = std::move(windows.front());
+        windows.pop_front();
+        changed.notify_all();
+        return true;
+    }
+
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        changed.notify_all();
+    }
+
+    void Cancel() {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+        windows.clear();
+        changed.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<ObjTextWindow> windows;
+    bool closed = false;
+    bool cancelled = false;
+};
+
+// 풀린 텍스트를 창마다 세고 파싱해 파일 순서대로 chunks 에 넣는다. 창마다 크기를 몰라 배열은
+// 창 전용 arena(stagingArenas)에 잡히므로, 호출자가 gatherOBJChunks() 로 한데 모은 뒤 버린다.
+bool parseGzipOBJ(const char* data, size_t size, unsigned int threadCount, std::vector<ObjChunk>& chunks,
+                  std::vector<std::unique_ptr<Arena>>& stagingArenas, uint64_t& textBytes) {
+    ObjWindowQueue queue;
+    GzipInflater inflater(data, size);
+    bool inflated = false;
+
+    std::thread producer([&] {
+        size_t index = 0;
+        std::vector<char> window;
+        window.reserve(kObjWindowBytes + kInflateFlushBytes);
+        auto sink = [&](const char* bytes, size_t count) {
+            window.insert(window.end(), bytes, bytes + count);
+            if (window.size() < kObjWindowBytes) return true;
+            size_t cut = window.size();
+            while (cut > 0 && window[cut - 1] != '\n') --cut;
+            if (cut == 0) return true; // 줄 하나가 창보다 길면 더 모은다
+            std::vector<char> rest(window.begin() + cut, window.end());
+            rest.reserve(kObjWindowBytes + kInflateFlushBytes);
+            window.resize(cut);
+            bool pushed = queue.Push({index++, std::move(window)});
+            window = std::move(rest);
+            return pushed;
+        };
+        inflated = inflater.Run(sink);
+        if (inflated && !window.empty())
+            inflated = queue.Push({index++, std::move(window)});
+        queue.Close();
+    });
+
+    struct ParsedWindow {
+        size_t index;
+        ObjChunk chunk;
+        std::unique_ptr<Arena> arena;
+    };
+    std::vector<std::vector<ParsedWindow>> parsed(std::max(1u, threadCount));
+    runParallel(parsed.size(), [&](size_t worker) {
+        ObjTextWindow window;
+        while (queue.Pop(window)) {
+            const char* begin = window.text.data();
+            const char* end = begin + window.text.size();
+            std::vector<ObjChunk> one(1);
+            countOBJChunk(begin, end, one[0]);
+            auto arena = std::make_unique<Arena>(objArrayBytes(one));
+            allocateOBJChunks(one, *arena);
+            parseOBJChunk(begin, end, one[0]);
+            parsed[worker].push_back({window.index, std::move(one[0]), std::move(arena)});
+            window.text = std::vector<char>(); // 다음 창을 기다리는 동안 잡고 있지 않게
+        }
+    });
+    producer.join();
+    textBytes = inflater.Produced();
+    if (!inflated) {
+        std::cerr << "Failed to decompress OBJ: " << (inflater.Error() ? inflater.Error() : "unknown error") << "\n";
+        return false;
+    }
+
+    size_t windowCount = 0;
+    for (const auto& list : parsed) windowCount += list.size();
+    chunks.assign(windowCount, ObjChunk());
+    stagingArenas.resize(windowCount);
+    for (auto& list : parsed) {
+        for (ParsedWindow& w : list) {
+            chunks[w.index] = std::move(w.chunk);
+            stagingArenas[w.index] = std::move(w.arena);
+        }
+    }
+    return true;
+}
+
+// 창마다 따로 잡힌 배열을 파일 전체 배열(arena)로 복사하고 청크가 새 구간을 가리키게 한다
+ObjArrays gatherOBJChunks(std::vector<ObjChunk>& chunks, Arena& arena) {
+    std::vector<ObjChunk> staged(chunks); // 옮기기 전 포인터
+    ObjArrays arrays = allocateOBJChunks(chunks, arena);
+    parallelRanges(chunks.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const ObjChunk& from = staged[i];
+            ObjChunk& to = chunks[i];
+            std::copy(from.positions, from.positions + from.positionCount, to.positions);
+            std::copy(from.normals, from.normals + from.normalCount, to.normals);
+            std::copy(from.texcoords, from.texcoords + from.texcoordCount, to.texcoords);
+            std::copy(from.corners, from.corners + from.cornerCount, to.corners);
+        }
+    });
+    return arrays;
+}
+
+// ===== OBJ Loader (v/vt/vn, v//vn, v 지원) =====
+// 단계별 시간 (--bench-load 용). gzip 입력은 세기/파싱이 압축 해제와 겹쳐 돌아 parse 에 합쳐진다.
+struct ObjLoadStats {
+    double openSeconds = 0.0;     // 열기 + 매핑
+    double countSeconds = 0.0;    // 1차: 레코드 수 세기
+    double parseSeconds = 0.0;    // 배열 잡기 + 2차: 숫자/인덱스 파싱
+    double resolveSeconds = 0.0;  // 면 인덱스 -> 정점 (용접)
+    double finishSeconds = 0.0;   // 재질 묶기, 법선 생성, bounds
+    uint64_t textBytes = 0;
+    size_t arenaBytes = 0;
+};
+
+// weldVertices: 같은 pi/ti/ni 조합은 하나의 정점으로 재사용 (false면 코너마다 새 정점)
+// threadCount : 파싱에 쓸 스레드 수 (0이면 하드웨어 코어 수)
+// stats       : 주면 단계별 시간을 채운다
+bool loadOBJ(const std::string& filename, ObjData& objData, bool weldVertices = true,
+             unsigned int threadCount = 0, ObjLoadStats* stats = nullptr) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    MappedFile file;
+    if (!file.Open(filename)) {
+        std::cerr << "Failed to open OBJ file: " << filename << std::endl;
+        return false;
+    }
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    auto openedTime = std::chrono::steady_clock::now();
+
+    ObjCompression compression = objCompression(file.Data(), file.Size());
+    if (compression == ObjCompression::Zstd) {
+        std::cerr << "zstd-compressed OBJ is not supported (no zstd decoder in this build): " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<ObjChunk> chunks;
+    std::vector<const char*> bounds;
+    std::vector<std::unique_ptr<Arena>> stagingArenas; // gzip: 창마다 파싱한 배열 (모은 뒤 버린다)
+    uint64_t textBytes = file.Size();
+    if (compression == ObjCompression::Gzip) {
+        // --- 압축 해제 스레드가 자른 창마다 세기 + 파싱 (파서 스레드 threadCount 개) ---
+        if (!parseGzipOBJ(file.Data(), file.Size(), threadCount, chunks, stagingArenas, textBytes))
+            return false;
+    } else {
+        // --- 라인 경계에서 청크 분할 ---
+        size_t chunkCount = std::min<size_t>(threadCount, file.Size() / kMinOBJChunkBytes);
+        chunkCount = std::max<size_t>(chunkCount, 1);
+
+        const char* begin = file.Data();
+        const char* end = begin + file.Size();
+        bounds.push_back(begin);
+        for (size_t i = 1; i < chunkCount; ++i) {
+            const char* split = begin + file.Size() * i / chunkCount;
+            if (split < bounds.back()) split = bounds.back();
+            const char* nl = (const char*)memchr(split, '\n', (size_t)(end - split));
+            bounds.push_back(nl ? nl + 1 : end);
+        }
+        bounds.push_back(end);
+
+        // --- 1차: 청크마다 레코드 수를 세서 모든 배열을 정확한 크기로 한 번에 잡는다 ---
+        chunks.resize(chunkCount);
+        runParallel(chunkCount, [&](size_t i) {
+            countOBJChunk(bounds[i], bounds[i + 1], chunks[i]);
+        });
+    }
+    auto countedTime = std::chrono::steady_clock::now();
+    size_t positionCount = 0, cornerCount = 0;
+    for (const ObjChunk& c : chunks) {
+        positionCount += c.positionCount;
+        cornerCount += c.cornerCount;
+    }
+    // 첫 블록 = 속성/면 배열 전체 + 용접 테이블 (정점 수 ~ 위치 수로 가정, 넘치면 테이블만 새 블록)
+    size_t weldBytes = weldVertices ? 4 * std::max<size_t>(positionCount, 512) * 16 : 0;
+    Arena arena(objArrayBytes(chunks) + weldBytes);
+    ObjArrays attributes;
+    if (compression == ObjCompression::Gzip) {
+        attributes = gatherOBJChunks(chunks, arena);
+        stagingArenas.clear();
+    } else {
+        attributes = allocateOBJChunks(chunks, arena);
+        // --- 2차: 청크 병렬 파싱 (각 청크가 파일 전체 배열의 자기 구간에 바로 쓴다) ---
+        runParallel(chunks.size(), [&](size_t i) {
+            parseOBJChunk(bounds[i], bounds[i + 1], chunks[i]);
+        });
+    }
+    auto parsedTime = std::chrono::steady_clock::now();
+
+    // --- 면 인덱스를 정점으로 해석 ---
+    auto makeVertex = [&](const VertexKey& key) {
+        Vertex v{};
+        v.pos = attributes.positions[key.pi];
+        if (attributes.normalCount && key.ni < attributes.normalCount)
+            v.nor = attributes.normals[key.ni];
+        else
+            v.nor = glm::vec3(0.0f, 1.0f, 0.0f);
+
+        if (attributes.texcoordCount && key.ti < attributes.texcoordCount)
+            v.tex = attributes.texcoords[key.ti];
+        else
+            v.tex = glm::vec2(0.0f, 0.0f);
+        return v;
+    };
+
+    objData.indices.resize(cornerCount);
+    if (weldVertices) {
+        // 첫 등장 순서대로 정점 번호를 매겨야 결과가 결정적이므로 순차 처리.
+        // 정점 수는 다 돌아야 알 수 있으므로 번호만 먼저 매기고 정점 배열은 정확한 크기로 나중에 채운다.
+        VertexWeldTable vertexCache(arena, positionCount);
+        unsigned int vertexCount = 0;
+        for (size_t i = 0; i < cornerCount; ++i) {
+            bool inserted;
+            objData.indices[i] = vertexCache.Insert(attributes.corners[i], vertexCount, inserted);
+            if (inserted) vertexCount++;
+        }
+        objData.vertices.resize(vertexCount);
+        parallelRanges(vertexCache.Capacity(), 1 << 16, [&](size_t begin, size_t end) {
+            vertexCache.ForEach(begin, end, [&](const VertexKey& key, unsigned int index) {
+                objData.vertices[index] = makeVertex(key);
+            });
+        });
+    } else {
+        objData.vertices.resize(cornerCount);
+        parallelRanges(cornerCount, 1 << 16, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                objData.vertices[i] = makeVertex(attributes.corners[i]);
+                objData.indices[i] = (unsigned int)i;
+            }
+        });
+    }
+
+    auto resolvedTime = std::chrono::steady_clock::now();
+
+    groupByMaterial(objData, chunks, filename);
+
+    // vn 레코드가 하나도 없으면 (0,1,0) 대신 매끄러운 법선을 만든다
+    if (attributes.normalCount == 0)
+        generateNormals(objData);
+
+    // 청크별 AABB 를 합치고, 그 중심에서 가장 먼 위치까지를 반지름으로
+    // (v 레코드 기준이라 면에서 안 쓰는 위치도 포함)
+    BoundsAccumulator positionBounds;
+    for (const ObjChunk& chunk : chunks)
+        positionBounds.Merge(chunk.bounds);
+    if (!positionBounds.Empty()) {
+        objData.boundsMin = positionBounds.Min();
+        objData.boundsMax = positionBounds.Max();
+        objData.sphereCenter = positionBounds.Center();
+        objData.sphereRadius = maxDistance(attributes.positions, attributes.positionCount, objData.sphereCenter);
+    }
+
+    auto endTime = std::chrono::steady_clock::now();
+    if (stats) {
+        auto between = [](std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+            return std::chrono::duration<double>(b - a).count();
+        };
+        stats->openSeconds = between(startTime, openedTime);
+        stats->countSeconds = compression == ObjCompression::Gzip ? 0.0 : between(openedTime, countedTime);
+        stats->parseSeconds = compression == ObjCompression::Gzip ? between(openedTime, parsedTime)
+                                                                  : between(countedTime, parsedTime);
+        stats->resolveSeconds = between(parsedTime, resolvedTime);
+        stats->finishSeconds = between(resolvedTime, endTime);
+        stats->textBytes = textBytes;
+        stats->arenaBytes = arena.BytesUsed();
+    }
+
+    double seconds = std::chrono::duration<double>(endTime - startTime).count();
+    double megabytes = textBytes / (1024.0 * 1024.0);
+    double fileMegabytes = file.Size() / (1024.0 * 1024.0);
+    file.Close();
+
+    std::cout << "Loaded OBJ file: " << filename << "\n";
+    std::cout << "  Vertices : " << objData.vertices.size() << "\n";
+    std::cout << "  Indices  : " << objData.indices.size()  << "\n";
+    std::cout << "  Triangles: " << objData.indices.size() / 3 << "\n";
+    std::cout << "  Bounds   : (" << objData.boundsMin.x << ", " << objData.boundsMin.y << ", " << objData.boundsMin.z
+              << ") - (" << objData.boundsMax.x << ", " << objData.boundsMax.y << ", " << objData.boundsMax.z
+              << "), radius " << objData.sphereRadius << "\n";
+    if (weldVertices && !objData.vertices.empty()) {
+        std::cout << "  Welded   : " << cornerCount << " corners -> "
+                  << objData.vertices.size() << " vertices ("
+                  << (double)cornerCount / objData.vertices.size() << "x)\n";
+    }
+    std::cout << "  Parsed   : " << megabytes << " MB in " << seconds * 1000.0 << " ms ("
+              << (seconds > 0.0 ? megabytes / seconds : 0.0) << " MB/s, ";
+    if (compression == ObjCompression::Gzip)
+        std::cout << "gzip " << fileMegabytes << " MB, " << chunks.size() << " windows, 1 inflate + "
+                  << threadCount << " parse threads)\n";
+    else
+        std::cout << chunks.size() << " thread" << (chunks.size() > 1 ? "s" : "") << ")\n";
+    std::cout << "  Arena    : " << arena.BytesUsed() / (1024.0 * 1024.0) << " MB used in "
+              << arena.BlockCount() << " block" << (arena.BlockCount() > 1 ? "s" : "") << "\n";
+
+    return !objData.vertices.empty() && !objData.indices.empty();
+}
+
+// ===== Tangent Generation (MikkTSpace 방식) =====
+// 노멀맵용 탄젠트 + 바이탄젠트 부호. MikkTSpace 와 같이 면의 UV 방향 벡터를 정점 법선
+// 평면에 투영하고 (투영된) 코너 각도로 가중해 합친다. 같은 정점이라도 UV 방향(거울 UV)이
+// 다르면 따로 묶고 정점을 나눈다. MikkTSpace 는 정점 주변의 연결된 팬 단위로 묶는데,
+// 여기서는 (정점, 방향) 단위로 묶는 것이 차이다.
+glm::vec3 anyPerpendicular(const glm::vec3& n) {
+    glm::vec3 axis = std::fabs(n.x) < 0.9f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+    return glm::normalize(glm::cross(n, glm::cross(axis, n)));
+}
+
+// 코너 각도 가중용 acos 근사 (Abramowitz & Stegun 4.4.45, 오차 < 7e-5 rad). std::acos 보다 몇 배 빠르고
+// 가중치로만 쓰므로 이 정도면 충분하다.
+float fastAcos(float x) {
+    float a = std::fabs(x);
+    float r = std::sqrt(1.0f - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f - 0.0187293f * a)));
+    return x < 0.0f ? 3.14159265f - r : r;
+}
+
+void generateTangents(ObjData& objData) {
+    auto startTime = std::chrono::steady_clock::now();
+    const std::vector<unsigned int>& indices = objData.indices;
+    size_t cornerCount = indices.size();
+    size_t triCount = cornerCount / 3;
+    size_t vertexCount = objData.vertices.size();
+
+    // 1) 면 단위 병렬: UV 방향 (+1 보존, -1 반전, 0 UV 퇴화 - 퇴화한 면은 이웃 면에 맡긴다)
+    std::vector<signed char> triOrientation(triCount);
+    parallelRanges(triCount, 8192, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            glm::vec2 t0 = objData.vertices[indices[t * 3]].tex;
+            glm::vec2 t21 = objData.vertices[indices[t * 3 + 1]].tex - t0;
+            glm::vec2 t31 = objData.vertices[indices[t * 3 + 2]].tex - t0;
+            float signedArea = t21.x * t31.y - t21.y * t31.x;
+            triOrientation[t] = signedArea > 0.0f ? 1 : signedArea < 0.0f ? -1 : 0;
+        }
+    });
+
+    // 코너 c 의 기여: 면의 UV s 방향을 코너 법선 평면에 투영하고 (투영된) 코너 각도로 가중.
+    // 코너마다 중간 버퍼에 담아 두면 큰 메시에서는 그 메모리 왕복이 계산보다 비싸서, 정점 패스에서 바로 계산한다.
+    auto cornerTangent = [&](unsigned int c) {
+        size_t t = c / 3;
+        int k = (int)(c % 3);
+        const Vertex* v[3] = {&objData.vertices[indices[t * 3]],
+                              &objData.vertices[indices[t * 3 + 1]],
+                              &objData.vertices[indices[t * 3 + 2]]};
+        glm::vec3 d1 = v[1]->pos - v[0]->pos, d2 = v[2]->pos - v[0]->pos;
+        glm::vec2 t21 = v[1]->tex - v[0]->tex, t31 = v[2]->tex - v[0]->tex;
+        glm::vec3 os = t31.y * d1 - t21.y * d2;
+        if (triOrientation[t] < 0) os = -os;
+
+        glm::vec3 n = v[k]->nor;
+        glm::vec3 tangent = os - n * glm::dot(n, os);
+        float len2 = glm::dot(tangent, tangent);
+        if (len2 <= 0.0f) return glm::vec3(0.0f);
+
+        glm::vec3 e1 = v[(k + 1) % 3]->pos - v[k]->pos;
+        glm::vec3 e2 = v[(k + 2) % 3]->pos - v[k]->pos;
+        e1 -= n * glm::dot(n, e1);
+        e2 -= n * glm::dot(n, e2);
+        float edges2 = glm::dot(e1, e1) * glm::dot(e2, e2);
+        if (edges2 <= 0.0f) return glm::vec3(0.0f);
+        float angle = fastAcos(std::max(-1.0f, std::min(1.0f, glm::dot(e1, e2) / std::sqrt(edges2))));
+        return tangent * (angle / std::sqrt(len2));
+    };
+
+    auto finishTangent = [&](const glm::vec3& sum, const glm::vec3& n, float sign) {
+        float len = glm::length(sum);
+        glm::vec3 t = len > 0.0f ? sum / len : anyPerpendicular(n);
+        return glm::vec4(t, sign);
+    };
+
+    // 정점 -> 코너 (CSR)
+    std::vector<unsigned int> cornerOffset(vertexCount + 1, 0);
+    for (unsigned int v : indices) cornerOffset[v + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v) cornerOffset[v + 1] += cornerOffset[v];
+    std::vector<unsigned int> vertexCorners(cornerCount);
+    {
+        std::vector<unsigned int> fill(cornerOffset.begin(), cornerOffset.end() - 1);
+        for (size_t c = 0; c < cornerCount; ++c)
+            vertexCorners[fill[indices[c]]++] = (unsigned int)c;
+    }
+
+    // 2) 정점 단위 병렬: 방향(+/-)별로 합산해 바로 정규화. [0] = 보존(+1), [1] = 반전(-1)
+    objData.tangents.resize(vertexCount);
+    std::unique_ptr<glm::vec4[]> mirroredTangents(new glm::vec4[vertexCount]); // 두 방향이 모두 쓰인 정점만 채운다
+    std::vector<unsigned char> bothOrientations(vertexCount);
+    parallelRanges(vertexCount, 8192, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            glm::vec3 sum[2] = {glm::vec3(0.0f), glm::vec3(0.0f)};
+            unsigned int used = 0; // bit0: +, bit1: -
+            for (unsigned int i = cornerOffset[v]; i < cornerOffset[v + 1]; ++i) {
+                unsigned int c = vertexCorners[i];
+                if (triOrientation[c / 3] == 0) continue; // 부호는 이웃 면에서 정한다
+                int side = triOrientation[c / 3] > 0 ? 0 : 1;
+                sum[side] += cornerTangent(c);
+                used |= 1u << side;
+            }
+            const glm::vec3& n = objData.vertices[v].nor;
+            // UV 퇴화 면에만 쓰인 정점은 + 로 둔다
+            objData.tangents[v] = used == 2 ? finishTangent(sum[1], n, -1.0f) : finishTangent(sum[0], n, 1.0f);
+            if (used == 3) mirroredTangents[v] = finishTangent(sum[1], n, -1.0f);
+            bothOrientations[v] = used == 3;
+        }
+    });
+
+    // 3) 두 방향이 모두 쓰인 정점은 반전 쪽을 새 정점으로 떼어낸다
+    std::vector<unsigned int> mirrored(vertexCount, 0xFFFFFFFFu);
+    size_t splitCount = 0;
+    for (size_t v = 0; v < vertexCount; ++v)
+        if (bothOrientations[v])
+            mirrored[v] = (unsigned int)(vertexCount + splitCount++);
+
+    if (splitCount) {
+        objData.tangents.resize(vertexCount + splitCount);
+        objData.vertices.reserve(vertexCount + splitCount);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            if (mirrored[v] == 0xFFFFFFFFu) continue;
+            objData.vertices.push_back(objData.vertices[v]);
+            objData.tangents[mirrored[v]] = mirroredTangents[v];
+        }
+        for (size_t c = 0; c < cornerCount; ++c) {
+            unsigned int v = objData.indices[c];
+            if (mirrored[v] != 0xFFFFFFFFu && triOrientation[c / 3] < 0)
+                objData.indices[c] = mirrored[v];
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Generated tangents: " << triCount << " triangles, " << splitCount
+              << " mirrored vertices split (" << seconds * 1000.0 << " ms, "
+              << (triCount ? seconds * 1000.0 * 1e6 / triCount : 0.0) << " ms per 1M triangles)\n";
+}
+
+// ===== Mesh Simplification (QEM LOD) =====
+// Garland & Heckbert 1997 의 이차 오차(quadric) 기반 엣지 붕괴. 새 정점을 만들지 않고 기존 정점
+// 쪽으로만 붕괴하므로 모든 LOD 가 같은 정점 버퍼를 공유하고 인덱스 구간만 다르다.
+// 열린 경계와 UV/법선 이음매(같은 위치, 다른 속성)는 그 선을 따라서만 붕괴해 모양을 유지한다.
+struct Quadric {
+    // 대칭 4x4 행렬의 위쪽 삼각형 성분, weight 는 더해진 가중치 합
+    double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+    double weight = 0;
+
+    // 평면 n·p + d = 0 까지의 거리 제곱 x w
+    void AddPlane(const glm::dvec3& n, double d, double w) {
+        a2 += w * n.x * n.x; ab += w * n.x * n.y; ac += w * n.x * n.z; ad += w * n.x * d;
+        b2 += w * n.y * n.y; bc += w * n.y * n.z; bd += w * n.y * d;
+        c2 += w * n.z * n.z; cd += w * n.z * d;
+        d2 += w * d * d;
+        weight += w;
+    }
+
+    void Add(const Quadric& q) {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+        weight += q.weight;
+    }
+
+    // p 에서의 가중 평균 거리 제곱
+    double Error(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                 + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                 + c2 * z * z + 2 * cd * z + d2;
+        return weight > 0 ? std::fabs(e) / weight : 0.0;
+    }
+};
+
+// Manifold: 내부 정점, 아무 이웃으로나 붕괴 가능
+// Border  : 열린 경계 위, 경계 엣지를 따라 다른 Border 로만
+// Seam    : 이음매 위 (같은 위치 정점 2개), 이음매 엣지를 따라 다른 Seam 으로 짝과 함께
+// Locked  : 그 밖의 경우 (이음매 교차점, 비다양체 등) - 움직이지 않음
+enum class SimplifyKind : uint8_t { Manifold, Border, Seam, Locked };
+
+const double kSimplifyEdgeWeight = 10.0; // 경계/이음매 엣지 quadric 가중치 (면 quadric 대비)
+
+// indices 를 ratios (내림차순, 원본 삼각형 수 대비) 까지 차례로 줄이며 목표에 닿을 때마다 그 시점의
+// 인덱스를 lodIndices 에 담는다. lodErrors 는 그때까지의 최대 붕괴 오차 (모델 단위 거리).
+// 잠긴 정점 때문에 더 줄일 수 없으면 거기서 멈추고 만든 LOD 까지만 돌려준다.
+void simplifyMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& source,
+                  const std::vector<float>& ratios, std::vector<std::vector<unsigned int>>& lodIndices,
+                  std::vector<float>& lodErrors) {
+    size_t vertexCount = vertices.size();
+    lodIndices.clear();
+    lodErrors.clear();
+    if (source.size() < 3) return;
+
+    // 1) 위치 그룹: remap[v] = 같은 위치의 대표 정점, wedge[v] = 같은 위치의 다음 정점 (원형 리스트)
+    std::vector<unsigned int> remap(vertexCount), wedge(vertexCount);
+    {
+        std::unordered_map<glm::vec3, unsigned int, PositionHash> first;
+        first.reserve(vertexCount);
+        for (unsigned int v = 0; v < (unsigned int)vertexCount; ++v) {
+            auto inserted = first.emplace(vertices[v].pos + glm::vec3(0.0f), v); // -0 을 +0 으로
+            unsigned int r = inserted.first->second;
+            remap[v] = r;
+            if (inserted.second) {
+                wedge[v] = v;
+            } else {
+                wedge[v] = wedge[r];
+                wedge[r] = v;
+            }
+        }
+    }
+
+    std::vector<unsigned int> indices = source;
+    std::vector<unsigned int> edgeOffset(vertexCount + 1), edgeTarget, groupOffset(vertexCount + 1), groupTris;
+    std::vector<char> referenced(vertexCount);
+
+    // 현재 인덱스 기준 나가는 엣지 (a, b, c 삼각형이면 a->b, b->c, c->a)
+    auto hasEdge = [&](unsigned int a, unsigned int b) {
+        for (unsigned int i = edgeOffset[a]; i < edgeOffset[a + 1]; ++i)
+            if (edgeTarget[i] == b) return true;
+        return false;
+    };
+    // 위치 기준: 양 끝의 같은 위치 정점 조합 중 하나라도 엣지가 있으면
+    auto hasPositionEdge = [&](unsigned int a, unsigned int b) {
+        unsigned int wa = a;
+        do {
+            unsigned int wb = b;
+            do {
+                if (hasEdge(wa, wb)) return true;
+                wb = wedge[wb];
+            } while (wb != b);
+            wa = wedge[wa];
+        } while (wa != a);
+        return false;
+    };
+    // 반대 방향 엣지가 위치 기준으로도 없으면 경계, 속성 기준으로만 없으면 이음매
+    auto isBorderEdge = [&](unsigned int a, unsigned int b) {
+        return (hasEdge(a, b) && !hasPositionEdge(b, a)) || (hasEdge(b, a) && !hasPositionEdge(a, b));
+    };
+    auto isSeamEdge = [&](unsigned int a, unsigned int b) {
+        return (hasEdge(a, b) && !hasEdge(b, a) && hasPositionEdge(b, a)) ||
+               (hasEdge(b, a) && !hasEdge(a, b) && hasPositionEdge(a, b));
+    };
+    // 같은 위치의 다른 (현재 쓰이는) 정점
+    auto partner = [&](unsigned int v) {
+        for (unsigned int w = wedge[v]; w != v; w = wedge[w])
+            if (referenced[w]) return w;
+        return v;
+    };
+
+    // 2) 위치 그룹마다 면 평면 quadric (면적 가중) + 경계/이음매 엣지에 수직인 평면 quadric
+    std::vector<Quadric> quadrics(vertexCount);
+    std::vector<SimplifyKind> kind(vertexCount);
+
+    // 엣지 CSR, 위치 그룹 -> 삼각형 CSR, 정점 종류를 현재 인덱스로 다시 만든다
+    auto buildTopology = [&]() {
+        size_t triCount = indices.size() / 3;
+        std::fill(edgeOffset.begin(), edgeOffset.end(), 0);
+        std::fill(groupOffset.begin(), groupOffset.end(), 0);
+        std::fill(referenced.begin(), referenced.end(), 0);
+        for (unsigned int v : indices) {
+            edgeOffset[v + 1]++;
+            groupOffset[remap[v] + 1]++;
+            referenced[v] = 1;
+        }
+        for (size_t v = 0; v < vertexCount; ++v) {
+            edgeOffset[v + 1] += edgeOffset[v];
+            groupOffset[v + 1] += groupOffset[v];
+        }
+        edgeTarget.resize(indices.size());
+        groupTris.resize(indices.size());
+        std::vector<unsigned int> edgeFill(edgeOffset.begin(), edgeOffset.end() - 1);
+        std::vector<unsigned int> groupFill(groupOffset.begin(), groupOffset.end() - 1);
+        for (size_t t = 0; t < triCount; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                unsigned int v = indices[t * 3 + k];
+                edgeTarget[edgeFill[v]++] = indices[t * 3 + (k + 1) % 3];
+                groupTris[groupFill[remap[v]]++] = (unsigned int)t;
+            }
+        }
+
+        std::vector<unsigned char> borderOut(vertexCount, 0), borderIn(vertexCount, 0);
+        std::vector<unsigned char> seamOut(vertexCount, 0), seamIn(vertexCount, 0);
+        std::vector<char> complex(vertexCount, 0);
+        auto bump = [](unsigned char& c) { if (c < 255) c++; };
+        for (unsigned int a = 0; a < (unsigned int)vertexCount; ++a) {
+            for (unsigned int i = edgeOffset[a]; i < edgeOffset[a + 1]; ++i) {
+                unsigned int b = edgeTarget[i];
+                // 같은 방향 엣지가 두 번 나오면 비다양체
+                for (unsigned int j = i + 1; j < edgeOffset[a + 1]; ++j)
+                    if (edgeTarget[j] == b) complex[a] = complex[b] = 1;
+                if (hasEdge(b, a)) continue;
+                if (hasPositionEdge(b, a)) {
+                    bump(seamOut[a]);
+                    bump(seamIn[b]);
+                } else {
+                    bump(borderOut[a]);
+                    bump(borderIn[b]);
+                }
+            }
+        }
+        for (unsigned int v = 0; v < (unsigned int)vertexCount; ++v) {
+            if (!referenced[v]) {
+                kind[v] = SimplifyKind::Locked;
+                continue;
+            }
+            int groupSize = 0;
+            unsigned int w = v;
+            do {
+                groupSize += referenced[w];
+                w = wedge[w];
+            } while (w != v);
+            bool border = borderOut[v] || borderIn[v];
+            bool seam = seamOut[v] || seamIn[v];
+            if (complex[v]) {
+                kind[v] = SimplifyKind::Locked;
+            } else if (groupSize == 1) {
+                kind[v] = !border && !seam ? SimplifyKind::Manifold
+                        : !seam && borderOut[v] == 1 && borderIn[v] == 1 ? SimplifyKind::Border
+                        : SimplifyKind::Locked;
+            } else if (groupSize == 2) {
+                unsigned int p = partner(v);
+                kind[v] = !border && !borderOut[p] && !borderIn[p] && !complex[p] &&
+                          seamOut[v] == 1 && seamIn[v] == 1 && seamOut[p] == 1 && seamIn[p] == 1
+                        ? SimplifyKind::Seam : SimplifyKind::Locked;
+            } else {
+                kind[v] = SimplifyKind::Locked;
+            }
+        }
+    };
+
+    buildTopology();
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const unsigned int* tri = &indices[t];
+        glm::dvec3 p[3] = {vertices[tri[0]].pos, vertices[tri[1]].pos, vertices[tri[2]].pos};
+        glm::dvec3 n = glm::cross(p[1] - p[0], p[2] - p[0]);
+        double len = glm::length(n);
+        if (len <= 0.0) continue;
+        n /= len;
+        for (int k = 0; k < 3; ++k)
+            quadrics[remap[tri[k]]].AddPlane(n, -glm::dot(n, p[0]), len * 0.5);
+        for (int k = 0; k < 3; ++k) {
+            unsigned int a = tri[k], b = tri[(k + 1) % 3];
+            if (hasEdge(b, a)) continue; // 내부 엣지
+            glm::dvec3 edge = p[(k + 1) % 3] - p[k];
+            double edgeLen = glm::length(edge);
+            if (edgeLen <= 0.0) continue;
+            glm::dvec3 en = glm::normalize(glm::cross(edge, n));
+            double w = kSimplifyEdgeWeight * edgeLen * edgeLen;
+            quadrics[remap[a]].AddPlane(en, -glm::dot(en, p[k]), w);
+            quadrics[remap[b]].AddPlane(en, -glm::dot(en, p[k]), w);
+        }
+    }
+
+    auto canCollapse = [&](unsigned int from, unsigned int to) {
+        switch (kind[from]) {
+        case SimplifyKind::Manifold:
+            return true;
+        case SimplifyKind::Border:
+            return kind[to] == SimplifyKind::Border && isBorderEdge(from, to);
+        case SimplifyKind::Seam: {
+            // 짝도 같은 이음매의 반대편 엣지를 따라 붕괴해야 한다
+            if (kind[to] != SimplifyKind::Seam || !isSeamEdge(from, to)) return false;
+            unsigned int pf = partner(from), pt = partner(to);
+            return hasEdge(pf, pt) || hasEdge(pt, pf);
+        }
+        default:
+            return false;
+        }
+    };
+
+    // from 그룹을 to 위치로 옮겼을 때 남는 삼각형 중 뒤집히는 것이 있으면 true
+    auto flips = [&](unsigned int from, unsigned int to) {
+        unsigned int rf = remap[from], rt = remap[to];
+        const glm::vec3& target = vertices[to].pos;
+        for (unsigned int i = groupOffset[rf]; i < groupOffset[rf + 1]; ++i) {
+            const unsigned int* tri = &indices[(size_t)groupTris[i] * 3];
+            if (remap[tri[0]] == rt || remap[tri[1]] == rt || remap[tri[2]] == rt) continue; // 사라지는 면
+            glm::vec3 p[3], q[3];
+            for (int k = 0; k < 3; ++k) {
+                p[k] = vertices[tri[k]].pos;
+                q[k] = remap[tri[k]] == rf ? target : p[k];
+            }
+            glm::vec3 n0 = glm::cross(p[1] - p[0], p[2] - p[0]);
+            glm::vec3 n1 = glm::cross(q[1] - q[0], q[2] - q[0]);
+            if (n0 != glm::vec3(0.0f) && glm::dot(n0, n1) <= 0.0f) return true;
+        }
+        return false;
+    };
+
+    struct Collapse {
+        unsigned int from, to;
+        double error;
+    };
+    std::vector<Collapse> candidates;
+    std::vector<unsigned int> collapseTo(vertexCount);
+    for (unsigned int v = 0; v < (unsigned int)vertexCount; ++v) collapseTo[v] = v;
+    std::vector<char> locked(vertexCount);
+    size_t sourceTris = source.size() / 3;
+    size_t lastTris = sourceTris;
+    double maxError = 0.0;
+    bool first = true;
+
+    for (float ratio : ratios) {
+        size_t target = (size_t)(sourceTris * (double)ratio);
+        while (indices.size() / 3 > target) {
+            if (!first) buildTopology();
+            first = false;
+            size_t triCount = indices.size() / 3;
+
+            // 3) 모든 엣지의 양방향 붕괴 후보를 오차 순으로
+            candidates.clear();
+            for (size_t t = 0; t < triCount; ++t) {
+                for (int k = 0; k < 3; ++k) {
+                    unsigned int a = indices[t * 3 + k], b = indices[t * 3 + (k + 1) % 3];
+                    if (a > b && hasEdge(b, a)) continue; // 내부 엣지는 반대쪽 삼각형에서 한 번만
+                    for (int dir = 0; dir < 2; ++dir) {
+                        unsigned int from = dir ? b : a, to = dir ? a : b;
+                        if (!canCollapse(from, to)) continue;
+                        Quadric q = quadrics[remap[from]];
+                        q.Add(quadrics[remap[to]]);
+                        candidates.push_back({from, to, q.Error(vertices[to].pos)});
+                    }
+                }
+            }
+            if (candidates.empty()) break;
+            std::sort(candidates.begin(), candidates.end(),
+                      [](const Collapse& x, const Collapse& y) { return x.error < y.error; });
+
+            // 4) 오차가 작은 것부터 붕괴. 한 패스에서 주변이 이미 바뀐 정점은 건너뛰어
+            //    뒤집힘 검사가 항상 최신 위치를 보게 한다. 붕괴 하나가 보통 삼각형 둘을 없앤다.
+            size_t goal = (triCount - target) / 2 + 1;
+            std::fill(locked.begin(), locked.end(), 0);
+            size_t performed = 0;
+            for (const Collapse& c : candidates) {
+                if (performed >= goal) break;
+                unsigned int rf = remap[c.from], rt = remap[c.to];
+                if (locked[rf] || locked[rt] || flips(c.from, c.to)) continue;
+
+                collapseTo[c.from] = c.to;
+                if (kind[c.from] == SimplifyKind::Seam)
+                    collapseTo[partner(c.from)] = partner(c.to);
+                for (unsigned int i = groupOffset[rf]; i < groupOffset[rf + 1]; ++i) {
+                    const unsigned int* tri = &indices[(size_t)groupTris[i] * 3];
+                    for (int k = 0; k < 3; ++k) locked[remap[tri[k]]] = 1;
+                }
+                locked[rt] = 1;
+                quadrics[rt].Add(quadrics[rf]);
+                maxError = std::max(maxError, c.error);
+                performed++;
+            }
+            if (performed == 0) break;
+
+            // 5) 인덱스 다시 쓰기, 위치가 겹친 (넓이 0) 삼각형 제거
+            size_t out = 0;
+            for (size_t t = 0; t < triCount; ++t) {
+                unsigned int a = collapseTo[indices[t * 3]];
+                unsigned int b = collapseTo[indices[t * 3 + 1]];
+                unsigned int c = collapseTo[indices[t * 3 + 2]];
+                if (remap[a] == remap[b] || remap[b] == remap[c] || remap[c] == remap[a]) continue;
+                indices[out++] = a;
+                indices[out++] = b;
+                indices[out++] = c;
+            }
+            indices.resize(out);
+        }
+
+        size_t tris = indices.size() / 3;
+        if (tris < lastTris) {
+            lodIndices.push_back(indices);
+            lodErrors.push_back((float)std::sqrt(maxError));
+            lastTris = tris;
+        }
+        if (tris > target) break; // 더 줄일 수 없음
+    }
+}
+
+// objData.indices 뒤에 LOD 인덱스를 이어 붙이고 objData.lods 에 구간을 기록한다.
+// error 는 모델 반지름 대비 비율이라 화면에 투영된 반지름(픽셀)을 곱하면 픽셀 오차가 된다.
+// generateTangents() 뒤, optimizeVertexCache() 전에 호출한다.
+void buildLods(ObjData& objData, const std::vector<float>& ratios = {0.5f, 0.25f, 0.125f}) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    // 재질 구간마다 따로 단순화해 재질 경계를 넘는 붕괴가 없게 한다 (재질이 없으면 전체가 한 구간).
+    // 구간이 쓰는 정점만 로컬 번호로 모아 넘기므로 구간이 많아도 전체 정점을 매번 훑지 않는다.
+    std::vector<Submesh> baseRanges = objData.submeshes;
+    if (baseRanges.empty())
+        baseRanges.push_back({0, (uint32_t)objData.indices.size(), 0});
+
+    const uint32_t kUnused = 0xFFFFFFFFu;
+    std::vector<uint32_t> localOf(objData.vertices.size(), kUnused);
+    std::vector<std::vector<std::vector<unsigned int>>> rangeLevels(baseRanges.size());
+    std::vector<float> lodErrors;
+    size_t levelCount = 0;
+    for (size_t r = 0; r < baseRanges.size(); ++r) {
+        const Submesh& range = baseRanges[r];
+        std::vector<Vertex> localVertices;
+        std::vector<unsigned int> globalOf, localIndices;
+        localIndices.reserve(range.indexCount);
+        for (uint32_t i = range.indexOffset; i < range.indexOffset + range.indexCount; ++i) {
+            unsigned int v = objData.indices[i];
+            if (localOf[v] == kUnused) {
+                localOf[v] = (uint32_t)localVertices.size();
+                localVertices.push_back(objData.vertices[v]);
+                globalOf.push_back(v);
+            }
+            localIndices.push_back(localOf[v]);
+        }
+        for (unsigned int v : globalOf) localOf[v] = kUnused;
+
+        std::vector<float> errors;
+        simplifyMesh(localVertices, localIndices, ratios, rangeLevels[r], errors);
+        for (auto& level : rangeLevels[r])
+            for (unsigned int& index : level) index = globalOf[index];
+        if (rangeLevels[r].empty())
+            rangeLevels[r].push_back(std::vector<unsigned int>(objData.indices.begin() + range.indexOffset,
+                                                               objData.indices.begin() + range.indexOffset + range.indexCount));
+        else
+            levelCount = std::max(levelCount, rangeLevels[r].size());
+        lodErrors.resize(std::max(lodErrors.size(), errors.size()), 0.0f);
+        for (size_t k = 0; k < errors.size(); ++k) lodErrors[k] = std::max(lodErrors[k], errors[k]);
+    }
+    for (size_t k = 1; k < lodErrors.size(); ++k) lodErrors[k] = std::max(lodErrors[k], lodErrors[k - 1]);
+
+    float radius = objData.sphereRadius;
+    bool hasSubmeshes = !objData.submeshes.empty();
+    objData.lods.clear();
+    objData.lods.push_back({0, (uint32_t)objData.indices.size(), 0, 0, 0.0f});
+    for (size_t k = 0; k < levelCount; ++k) {
+        float error = radius > 0.0f ? lodErrors[k] / radius : 0.0f;
+        MeshLod lod{(uint32_t)objData.indices.size(), 0, 0, 0, error};
+        // 더 줄일 수 없던 구간은 마지막으로 줄인 결과를 그대로 쓴다
+        for (size_t r = 0; r < baseRanges.size(); ++r) {
+            const std::vector<unsigned int>& level = rangeLevels[r][std::min(k, rangeLevels[r].size() - 1)];
+            if (hasSubmeshes && !level.empty())
+                objData.submeshes.push_back({(uint32_t)objData.indices.size(), (uint32_t)level.size(),
+                                             baseRanges[r].material});
+            objData.indices.insert(objData.indices.end(), level.begin(), level.end());
+        }
+        lod.indexCount = (uint32_t)objData.indices.size() - lod.indexOffset;
+        objData.lods.push_back(lod);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "LOD chain: " << objData.lods.size() << " levels (" << seconds * 1000.0 << " ms";
+    if (hasSubmeshes) std::cout << ", " << baseRanges.size() << " material ranges";
+    std::cout << ")\n";
+    size_t baseTris = objData.lods[0].indexCount / 3;
+    for (size_t i = 0; i < objData.lods.size(); ++i) {
+        size_t tris = objData.lods[i].indexCount / 3;
+        std::cout << "  LOD " << i << ": " << tris << " triangles ("
+                  << (baseTris ? 100.0 * tris / baseTris : 0.0) << "%), error "
+                  << objData.lods[i].error * radius << " (" << objData.lods[i].error * 100.0f << "% of radius)\n";
+    }
+}
+
+// ===== Vertex Cache Optimization (Forsyth) =====
+// OBJ 면 순서는 DCC 툴에 따라 사실상 무작위라 post-transform 캐시 적중률이 낮다.
+// 삼각형을 Forsyth 방식으로 재정렬하고, 정점도 첫 사용 순서로 다시 배치한다.
+struct VertexCacheStats {
+    float acmr; // 삼각형당 변환된 정점 수 (0.5 ~ 3.0)
+    float atvr; // 고유 정점당 변환된 정점 수 (1.0 이 최적)
+};
+
+// FIFO 캐시를 흉내내 인덱스 버퍼의 정점 셰이더 호출 수를 센다
+VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                    unsigned int cacheSize = 16) {
+    std::vector<unsigned int> timestamp(vertexCount, 0);
+    std::vector<bool> used(vertexCount, false);
+    unsigned int time = cacheSize + 1;
+    size_t transformed = 0, unique = 0;
+    for (unsigned int v : indices) {
+        if (time - timestamp[v] > cacheSize) {
+            timestamp[v] = time++;
+            transformed++;
+        }
+        if (!used[v]) {
+            used[v] = true;
+            unique++;
+        }
+    }
+    VertexCacheStats stats{0.0f, 0.0f};
+    if (!indices.empty()) stats.acmr = (float)transformed / (indices.size() / 3);
+    if (unique) stats.atvr = (float)transformed / unique;
+    return stats;
+}
+
+const int kForsythCacheSize = 32;
+const int kForsythMaxValence = 64;
+
+struct ForsythScores {
+    float cache[kForsythCacheSize];
+    float valence[kForsythMaxValence];
+
+    ForsythScores() {
+        const float lastTriScore = 0.75f, cacheDecayPower = 1.5f;
+        const float valenceBoostScale = 2.0f, valenceBoostPower = 0.5f;
+        for (int i = 0; i < kForsythCacheSize; ++i) {
+            if (i < 3) {
+                cache[i] = lastTriScore;
+            } else {
+                float scaler = 1.0f - (float)(i - 3) / (kForsythCacheSize - 3);
+                cache[i] = std::pow(scaler, cacheDecayPower);
+            }
+        }
+        valence[0] = 0.0f;
+        for (int i = 1; i < kForsythMaxValence; ++i)
+            valence[i] = valenceBoostScale * std::pow((float)i, -valenceBoostPower);
+    }
+
+    float Score(int cachePos, unsigned int remaining) const {
+        if (remaining == 0) return -1.0f;
+        float score = cachePos >= 0 ? cache[cachePos] : 0.0f;
+        return score + valence[std::min<unsigned int>(remaining, kForsythMaxValence - 1)];
+    }
+};
+
+// 정점을 인덱스 버퍼의 첫 사용 순서로 재배치한다 (참조되지 않는 정점은 뒤로)
+void optimizeVertexFetch(ObjData& objData) {
+    size_t vertexCount = objData.vertices.size();
+    const unsigned int kUnassigned = 0xFFFFFFFFu;
+    std::vector<unsigned int> remap(vertexCount, kUnassigned);
+    std::vector<unsigned int> order;
+    order.reserve(vertexCount);
+    for (unsigned int& v : objData.indices) {
+        if (remap[v] == kUnassigned) {
+            remap[v] = (unsigned int)order.size();
+            order.push_back(v);
+        }
+        v = remap[v];
+    }
+    for (size_t v = 0; v < vertexCount; ++v)
+        if (remap[v] == kUnassigned)
+            order.push_back((unsigned int)v);
+
+    std::vector<Vertex> vertices(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) vertices[i] = objData.vertices[order[i]];
+    objData.vertices.swap(vertices);
+    if (!objData.tangents.empty()) {
+        std::vector<glm::vec4> tangents(vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i) tangents[i] = objData.tangents[order[i]];
+        objData.tangents.swap(tangents);
+    }
+}
+
+// 인덱스 구간 하나를 제자리에서 재정렬한다. indices 는 [0, vertexCount) 의 로컬 번호여야 한다
+// (정점 단위 배열을 vertexCount 크기로 잡으므로 전체 메시 번호를 넘기면 구간마다 전체 정점을 훑는다).
+void optimizeVertexCacheRange(unsigned int* indices, size_t indexCount, size_t vertexCount) {
+    size_t triCount = indexCount / 3;
+    if (triCount == 0) return;
+    static const ForsythScores scores;
+
+    // 정점 -> 인접 삼각형 (CSR). 삼각형이 출력되면 활성 구간에서 빠진다.
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (size_t i = 0; i < indexCount; ++i) remaining[indices[i]]++;
+    std::vector<unsigned int> adjOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) adjOffset[v + 1] = adjOffset[v] + remaining[v];
+    std::vector<unsigned int> adjacency(indexCount);
+    {
+        std::vector<unsigned int> fill(adjOffset.begin(), adjOffset.end() - 1);
+        for (size_t t = 0; t < triCount; ++t)
+            for (int k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = (unsigned int)t;
+    }
+
+    std::vector<int> cachePos(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = scores.Score(-1, remaining[v]);
+
+    std::vector<float> triScore(triCount);
+    std::vector<bool> emitted(triCount, false);
+    int bestTri = -1;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triCount; ++t) {
+        const unsigned int* tri = &indices[t * 3];
+        triScore[t] = vertexScore[tri[0]] + vertexScore[tri[1]] + vertexScore[tri[2]];
+        if (triScore[t] > bestScore) {
+            bestScore = triScore[t];
+            bestTri = (int)t;
+        }
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(indexCount);
+    std::vector<unsigned int> cache, newCache;
+    cache.reserve(kForsythCacheSize + 3);
+    newCache.reserve(kForsythCacheSize + 3);
+    size_t scanCursor = 0;
+
+    for (size_t n = 0; n < triCount; ++n) {
+        // 캐시 주변에 후보가 없으면 (dead end) 아직 안 나간 다음 삼각형으로 넘어간다
+        if (bestTri < 0) {
+            while (emitted[scanCursor]) ++scanCursor;
+            bestTri = (int)scanCursor;
+        }
+
+        const unsigned int* tri = &indices[(size_t)bestTri * 3];
+        emitted[bestTri] = true;
+        newCache.clear();
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = tri[k];
+            output.push_back(v);
+            newCache.push_back(v);
+
+            unsigned int* adj = &adjacency[adjOffset[v]];
+            unsigned int count = remaining[v];
+            for (unsigned int i = 0; i < count; ++i) {
+                if (adj[i] == (unsigned int)bestTri) {
+                    adj[i] = adj[count - 1];
+                    break;
+                }
+            }
+            remaining[v]--;
+        }
+        for (unsigned int v : cache)
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                newCache.push_back(v);
+
+        for (size_t i = 0; i < newCache.size(); ++i) {
+            unsigned int v = newCache[i];
+            cachePos[v] = i < (size_t)kForsythCacheSize ? (int)i : -1;
+            vertexScore[v] = scores.Score(cachePos[v], remaining[v]);
+        }
+        if (newCache.size() > (size_t)kForsythCacheSize)
+            newCache.resize(kForsythCacheSize);
+        cache.swap(newCache);
+
+        // 점수가 바뀐 정점에 붙은 삼각형만 다시 계산
+        bestTri = -1;
+        bestScore = -1.0f;
+        for (unsigned int v : cache) {
+            const unsigned int* adj = &adjacency[adjOffset[v]];
+            for (unsigned int i = 0; i < remaining[v]; ++i) {
+                unsigned int t = adj[i];
+                const unsigned int* tv = &indices[(size_t)t * 3];
+                triScore[t] = vertexScore[tv[0]] + vertexScore[tv[1]] + vertexScore[tv[2]];
+                if (triScore[t] > bestScore) {
+                    bestScore = triScore[t];
+                    bestTri = (int)t;
+                }
+            }
+        }
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+// LOD/재질 구간이 있으면 구간마다 따로 재정렬한다 (정점 순서는 전체 인덱스 기준).
+// buildLods 처럼 구간이 쓰는 정점만 로컬 번호로 모아 넘기므로 구간이 많아도 구간 크기만큼만 든다.
+void optimizeVertexCache(ObjData& objData) {
+    std::vector<unsigned int>& indices = objData.indices;
+    size_t vertexCount = objData.vertices.size();
+    if (indices.size() < 3) return;
+
+    VertexCacheStats before = analyzeVertexCache(indices, vertexCount);
+    const uint32_t kUnused = 0xFFFFFFFFu;
+    std::vector<uint32_t> localOf(vertexCount, kUnused);
+    std::vector<unsigned int> globalOf, localIndices;
+    for (const MeshLod& range : indexRanges(objData)) {
+        unsigned int* rangeIndices = indices.data() + range.indexOffset;
+        globalOf.clear();
+        localIndices.resize(range.indexCount);
+        for (uint32_t i = 0; i < range.indexCount; ++i) {
+            unsigned int v = rangeIndices[i];
+            if (localOf[v] == kUnused) {
+                localOf[v] = (uint32_t)globalOf.size();
+                globalOf.push_back(v);
+            }
+            localIndices[i] = localOf[v];
+        }
+        for (unsigned int v : globalOf) localOf[v] = kUnused;
+
+        optimizeVertexCacheRange(localIndices.data(), range.indexCount, globalOf.size());
+        for (uint32_t i = 0; i < range.indexCount; ++i) rangeIndices[i] = globalOf[localIndices[i]];
+    }
+    optimizeVertexFetch(objData);
+
+    VertexCacheStats after = analyzeVertexCache(indices, vertexCount);
+    std::cout << "Vertex cache: ACMR " << before.acmr << " -> " << after.acmr
+              << ", ATVR " << before.atvr << " -> " << after.atvr << "\n";
+}
+
+// ===== Overdraw Optimization =====
+// 캐시 최적화된 인덱스 버퍼를 클러스터로 나누고, 바깥을 향하는 클러스터부터 그리도록
+// 정렬해서 흔한 시점에서 early-Z 가 더 많은 프래그먼트를 버리게 한다.
+// (Sander et al. 2007, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw")
+struct OverdrawStats {
+    size_t covered;  // 최소 한 번 그려진 픽셀 수
+    size_t shaded;   // 깊이 테스트를 통과한 프래그먼트 수
+    float overdraw;  // shaded / covered (1.0 이 최적)
+};
+
+// 피보나치 구 위의 여러 방향에서 직교 투영으로 메시를 래스터라이즈해 overdraw 를 잰다.
+// 인덱스 순서대로 깊이 테스트(LESS)를 하며, 앞면/뒷면 삼각형을 별도 깊이 버퍼에 그려서
+// 후면 컬링을 켠 상태로 각 방향과 그 반대 방향에서 본 것과 같게 센다.
+OverdrawStats analyzeOverdraw(const ObjData& objData, int viewCount = 16, int resolution = 256) {
+    const std::vector<unsigned int>& indices = objData.indices;
+    glm::vec3 center = objData.sphereCenter;
+    float radius = objData.sphereRadius;
+    if (indices.empty() || radius <= 0.0f) return OverdrawStats{0, 0, 0.0f};
+
+    size_t workerCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), (size_t)viewCount);
+    std::vector<size_t> covered(workerCount, 0), shaded(workerCount, 0);
+
+    runParallel(workerCount, [&](size_t worker) {
+        std::vector<float> depth[2];
+        depth[0].resize((size_t)resolution * resolution);
+        depth[1].resize((size_t)resolution * resolution);
+        std::vector<glm::vec3> projected(objData.vertices.size());
+        float scale = (resolution - 1) * 0.5f / radius;
+
+        for (int view = (int)worker; view < viewCount; view += (int)workerCount) {
+            // 방향과 그에 수직인 두 축
+            float y = 1.0f - 2.0f * (view + 0.5f) / viewCount;
+            float r = std::sqrt(std::max(0.0f, 1.0f - y * y));
+            float phi = view * 2.39996323f;
+            glm::vec3 dir(r * std::cos(phi), y, r * std::sin(phi));
+            glm::vec3 up = std::fabs(dir.y) < 0.99f ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
+            glm::vec3 axisU = glm::normalize(glm::cross(up, dir));
+            glm::vec3 axisV = glm::cross(dir, axisU);
+
+            for (size_t i = 0; i < objData.vertices.size(); ++i) {
+                glm::vec3 p = objData.vertices[i].pos - center;
+                projected[i] = glm::vec3(glm::dot(p, axisU) * scale + resolution * 0.5f,
+                                         glm::dot(p, axisV) * scale + resolution * 0.5f,
+                                         glm::dot(p, dir));
+            }
+            for (auto& buffer : depth)
+                std::fill(buffer.begin(), buffer.end(), std::numeric_limits<float>::infinity());
+
+            for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+                glm::vec3 a = projected[indices[t]], b = projected[indices[t + 1]], c = projected[indices[t + 2]];
+                float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+                if (area == 0.0f) continue;
+                // 관찰자는 -dir 쪽에 있고, (u, v, dir) 이 오른손 좌표계라 CCW 앞면은 area < 0.
+                // area > 0 인 삼각형은 반대 방향(+dir)에서 본 앞면이므로 깊이를 뒤집어 따로 그린다.
+                int side = area < 0.0f ? 0 : 1;
+                if (side == 0) {
+                    std::swap(b, c);
+                    area = -area;
+                } else {
+                    a.z = -a.z;
+                    b.z = -b.z;
+                    c.z = -c.z;
+                }
+                std::vector<float>& sideDepth = depth[side];
+                int minX = std::max(0, (int)std::floor(std::min({a.x, b.x, c.x})));
+                int maxX = std::min(resolution - 1, (int)std::ceil(std::max({a.x, b.x, c.x})));
+                int minY = std::max(0, (int)std::floor(std::min({a.y, b.y, c.y})));
+                int maxY = std::min(resolution - 1, (int)std::ceil(std::max({a.y, b.y, c.y})));
+                float invArea = 1.0f / area;
+
+                for (int py = minY; py <= maxY; ++py) {
+                    float sy = py + 0.5f;
+                    for (int px = minX; px <= maxX; ++px) {
+                        float sx = px + 0.5f;
+                        float w0 = (c.x - b.x) * (sy - b.y) - (c.y - b.y) * (sx - b.x);
+                        float w1 = (a.x - c.x) * (sy - c.y) - (a.y - c.y) * (sx - c.x);
+                        float w2 = (b.x - a.x) * (sy - a.y) - (b.y - a.y) * (sx - a.x);
+                        if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+                        float z = (w0 * a.z + w1 * b.z + w2 * c.z) * invArea;
+                        float& d = sideDepth[(size_t)py * resolution + px];
+                        if (z < d) {
+                            d = z;
+                            shaded[worker]++;
+                        }
+                    }
+                }
+            }
+            for (auto& buffer : depth)
+                for (float d : buffer)
+                    if (d != std::numeric_limits<float>::infinity()) covered[worker]++;
+        }
+    });
+
+    OverdrawStats stats{0, 0, 0.0f};
+    for (size_t i = 0; i < workerCount; ++i) {
+        stats.covered += covered[i];
+        stats.shaded += shaded[i];
+    }
+    if (stats.covered) stats.overdraw = (float)stats.shaded / stats.covered;
+    return stats;
+}
+
+// FIFO 캐시 시뮬레이션에서 삼각형 하나가 일으키는 미스 수
+struct FifoCache {
+    std::vector<unsigned int> timestamp;
+    unsigned int time;
+    unsigned int size;
+
+    FifoCache(size_t vertexCount, unsigned int cacheSize)
+        : timestamp(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+    void Reset() { time += size + 1; }
+
+    unsigned int Misses(const unsigned int* tri) {
+        unsigned int misses = 0;
+        for (int k = 0; k < 3; ++k) {
+            if (time - timestamp[tri[k]] > size) {
+                timestamp[tri[k]] = time++;
+                misses++;
+            }
+        }
+        return misses;
+    }
+};
+
+const unsigned int kOverdrawCacheSize = 16;
+
+// 인덱스 구간 하나를 제자리에서 클러스터 정렬하고 클러스터 수를 돌려준다
+size_t optimizeOverdrawRange(const std::vector<Vertex>& vertices, unsigned int* indices, size_t indexCount,
+                             float acmrThreshold) {
+    size_t triCount = indexCount / 3;
+    if (triCount == 0) return 0;
+
+    // 1) 하드 경계: 세 정점이 모두 캐시 미스인 삼각형에서 캐시가 사실상 리셋된다
+    FifoCache cache(vertices.size(), kOverdrawCacheSize);
+    std::vector<size_t> hard{0};
+    for (size_t t = 0; t < triCount; ++t)
+        if (cache.Misses(&indices[t * 3]) == 3 && t > 0)
+            hard.push_back(t);
+    hard.push_back(triCount);
+
+    // 2) 소프트 경계: 하드 클러스터 안에서 누적 ACMR 이 임계값 이하로 내려가면 자른다
+    std::vector<size_t> clusters;
+    for (size_t h = 0; h + 1 < hard.size(); ++h) {
+        size_t start = hard[h], end = hard[h + 1];
+        cache.Reset();
+        size_t clusterMisses = 0;
+        for (size_t t = start; t < end; ++t)
+            clusterMisses += cache.Misses(&indices[t * 3]);
+        float threshold = acmrThreshold * clusterMisses / (end - start);
+
+        cache.Reset();
+        size_t runningMisses = 0, runningTris = 0;
+        clusters.push_back(start);
+        for (size_t t = start; t < end; ++t) {
+            runningMisses += cache.Misses(&indices[t * 3]);
+            runningTris++;
+            if (runningMisses <= threshold * runningTris && t + 1 < end) {
+                clusters.push_back(t + 1);
+                cache.Reset();
+                runningMisses = runningTris = 0;
+            }
+        }
+    }
+    clusters.push_back(triCount);
+    size_t clusterCount = clusters.size() - 1;
+
+    // 3) 클러스터마다 (중심 - 메시 중심) · 평균 법선 으로 바깥쪽 정도를 구해 내림차순 정렬
+    glm::vec3 meshCenter(0.0f);
+    float meshArea = 0.0f;
+    std::vector<glm::vec3> clusterCenter(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormal(clusterCount, glm::vec3(0.0f));
+    std::vector<float> clusterArea(clusterCount, 0.0f);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+            const glm::vec3& a = vertices[indices[t * 3]].pos;
+            const glm::vec3& b = vertices[indices[t * 3 + 1]].pos;
+            const glm::vec3& d = vertices[indices[t * 3 + 2]].pos;
+            glm::vec3 n = glm::cross(b - a, d - a);
+            float area = glm::length(n);
+            clusterCenter[c] += (a + b + d) * (area / 3.0f);
+            clusterNormal[c] += n;
+            clusterArea[c] += area;
+        }
+        meshCenter += clusterCenter[c];
+        meshArea += clusterArea[c];
+    }
+    if (meshArea > 0.0f) meshCenter /= meshArea;
+
+    std::vector<float> sortKey(clusterCount, 0.0f);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        if (clusterArea[c] <= 0.0f) continue;
+        glm::vec3 center = clusterCenter[c] / clusterArea[c];
+        float len = glm::length(clusterNormal[c]);
+        if (len > 0.0f)
+            sortKey[c] = glm::dot(center - meshCenter, clusterNormal[c] / len);
+    }
+
+    std::vector<size_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) order[c] = c;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<unsigned int> output;
+    output.reserve(indexCount);
+    for (size_t c : order)
+        output.insert(output.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+    std::copy(output.begin(), output.end(), indices);
+    return clusterCount;
+}
+
+// acmrThreshold: 클러스터를 나눠서 생기는 ACMR 손해의 허용 배수 (1.05 = 5%)
+// 전/후 overdraw 는 여기서 재지 않는다 (analyzeOverdraw 가 이 함수보다 몇 배 느리다). --bench-load 표에 나온다.
+void optimizeOverdraw(ObjData& objData, float acmrThreshold = 1.05f) {
+    std::vector<unsigned int>& indices = objData.indices;
+    if (indices.size() < 3) return;
+
+    VertexCacheStats before = analyzeVertexCache(indices, objData.vertices.size(), kOverdrawCacheSize);
+    size_t clusterCount = 0;
+    for (const MeshLod& range : indexRanges(objData))
+        clusterCount += optimizeOverdrawRange(objData.vertices, indices.data() + range.indexOffset,
+                                              range.indexCount, acmrThreshold);
+
+    // 삼각형 순서가 바뀌었으니 정점도 다시 첫 사용 순서로
+    optimizeVertexFetch(objData);
+
+    VertexCacheStats after = analyzeVertexCache(indices, objData.vertices.size(), kOverdrawCacheSize);
+    std::cout << "Overdraw: " << clusterCount << " clusters, ACMR " << before.acmr
+              << " -> " << after.acmr << "\n";
+}
+
+// ===== Index Format (8/16/32비트 인덱스 자동 선택) =====
+size_t indexFormatSize(IndexFormat format) {
+    switch (format) {
+    case IndexFormat::UInt8:  return 1;
+    case IndexFormat::UInt16: return 2;
+    default:                  return 4;
+    }
+}
+
+template <typename T>
+void storeIndices(std::vector<unsigned char>& packed, const unsigned int* src, size_t count, unsigned int base) {
+    size_t offset = packed.size();
+    packed.resize(offset + count * sizeof(T));
+    T* dst = (T*)(packed.data() + offset);
+    for (size_t i = 0; i < count; ++i)
+        dst[i] = (T)(src[i] - base);
+}
+
+void storeIndices(std::vector<unsigned char>& packed, IndexFormat format,
+                  const unsigned int* src, size_t count, unsigned int base) {
+    switch (format) {
+    case IndexFormat::UInt8:  storeIndices<uint8_t>(packed, src, count, base); break;
+    case IndexFormat::UInt16: storeIndices<uint16_t>(packed, src, count, base); break;
+    default:                  storeIndices<uint32_t>(packed, src, count, base); break;
+    }
+}
+
+// 정점 수에 맞는 가장 작은 인덱스 포맷으로 packedIndices 를 만든다.
+// strict16 이면 65536 정점을 넘는 메시도 청크마다 정점을 복제해 16비트로 나눈다.
+// (이 경우 vertices/indices 도 청크 순서대로 다시 쓰여진다)
+void packIndices(ObjData& objData, bool strict16 = false) {
+    const size_t kMax8 = 1u << 8, kMax16 = 1u << 16;
+    size_t vertexCount = objData.vertices.size();
+
+    objData.packedIndices.clear();
+    objData.chunks.clear();
+
+    if (vertexCount <= kMax16 || !strict16) {
+        objData.indexFormat = vertexCount <= kMax8  ? IndexFormat::UInt8
+                            : vertexCount <= kMax16 ? IndexFormat::UInt16
+                            : IndexFormat::UInt32;
+        objData.packedIndices.reserve(objData.indices.size() * indexFormatSize(objData.indexFormat));
+        storeIndices(objData.packedIndices, objData.indexFormat,
+                     objData.indices.data(), objData.indices.size(), 0);
+        objData.chunks.push_back({0, (uint32_t)objData.indices.size(), 0, (uint32_t)vertexCount});
+        std::cout << "Index format: " << indexFormatSize(objData.indexFormat) * 8 << "-bit\n";
+        return;
+    }
+
+    // 삼각형 순서대로 청크에 담다가 로컬 정점이 65536개를 넘으면 새 청크 시작
+    objData.indexFormat = IndexFormat::UInt16;
+    std::vector<Vertex> vertices;
+    std::vector<glm::vec4> tangents;
+    std::vector<unsigned int> indices;
+    vertices.reserve(vertexCount + vertexCount / 8);
+    indices.reserve(objData.indices.size());
+
+    const uint32_t kUnused = 0xFFFFFFFFu;
+    std::vector<uint32_t> remap(vertexCount, kUnused);
+    std::vector<uint32_t> remapChunk(vertexCount, kUnused);
+    MeshChunk chunk{0, 0, 0, 0};
+
+    auto closeChunk = [&]() {
+        chunk.indexCount = (uint32_t)(indices.size() - chunk.indexOffset);
+        chunk.vertexCount = (uint32_t)(vertices.size() - chunk.baseVertex);
+        storeIndices(objData.packedIndices, IndexFormat::UInt16,
+                     indices.data() + chunk.indexOffset, chunk.indexCount, chunk.baseVertex);
+        objData.chunks.push_back(chunk);
+        chunk = MeshChunk{(uint32_t)indices.size(), 0, (uint32_t)vertices.size(), 0};
+    };
+
+    uint32_t chunkId = 0;
+    for (size_t t = 0; t + 2 < objData.indices.size(); t += 3) {
+        const unsigned int* tri = &objData.indices[t];
+        size_t newVertices = 0;
+        for (int k = 0; k < 3; ++k)
+            if (remapChunk[tri[k]] != chunkId) newVertices++;
+        if (vertices.size() - chunk.baseVertex + newVertices > kMax16) {
+            closeChunk();
+            chunkId++;
+        }
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = tri[k];
+            if (remapChunk[v] != chunkId) {
+                remapChunk[v] = chunkId;
+                remap[v] = (uint32_t)vertices.size();
+                vertices.push_back(objData.vertices[v]);
+                if (!objData.tangents.empty())
+                    tangents.push_back(objData.tangents[v]);
+            }
+            indices.push_back(remap[v]);
+        }
+    }
+    if (indices.size() > chunk.indexOffset)
+        closeChunk();
+
+    std::cout << "Index format: 16-bit, " << objData.chunks.size() << " chunks ("
+              << objData.vertices.size() << " -> " << vertices.size() << " vertices)\n";
+    objData.vertices.swap(vertices);
+    objData.tangents.swap(tangents);
+    objData.indices.swap(indices);
+}
+
+// ===== Meshlets (클러스터 컬링) =====
+// 인덱스 버퍼를 정점 64개 / 삼각형 124개 이하의 연속 구간으로 나누고, 구간마다 바운딩 구와
+// 법선 콘을 저장한다. 매 프레임 CPU 에서 뒤를 향하거나 절두체 밖인 클러스터를 버린다.
+const size_t kMeshletMaxVertices = 64;
+const size_t kMeshletMaxTriangles = 124;
+
+// 청크마다 (LOD 가 있으면 청크와 LOD 구간이 겹치는 부분마다) 삼각형 인접 관계를 따라
+// 클러스터를 키운다: 현재 클러스터 정점에 붙은 삼각형 중 새 정점이 가장 적고, 중심에 가깝고,
+// 법선이 콘 축과 비슷한 것을 고른다. 그 결과 순서대로 indices/packedIndices 구간을 다시 써서
+// 클러스터마다 연속 구간이 되게 한다 (청크의 정점 집합은 그대로라 baseVertex 도 유효).
+// packIndices() 뒤, quantizeVertices() 전에 호출한다.
+void buildMeshlets(ObjData& objData) {
+    std::vector<unsigned int>& indices = objData.indices;
+    const std::vector<Vertex>& vertices = objData.vertices;
+    objData.meshlets.clear();
+
+    const uint32_t kUnused = 0xFFFFFFFFu;
+    std::vector<uint32_t> stamp(vertices.size(), kUnused);
+    std::vector<unsigned int> meshletVertices;
+    meshletVertices.reserve(kMeshletMaxVertices);
+
+    auto faceNormal = [&](const unsigned int* tri) {
+        glm::vec3 n = glm::cross(vertices[tri[1]].pos - vertices[tri[0]].pos,
+                                 vertices[tri[2]].pos - vertices[tri[0]].pos);
+        float len = glm::length(n);
+        return len > 0.0f ? n / len : glm::vec3(0.0f);
+    };
+
+    // tris 는 이 클러스터의 삼각형 인덱스 (indexCount 개)
+    auto closeMeshlet = [&](const unsigned int* tris, uint32_t indexOffset, uint32_t indexCount, uint32_t baseVertex) {
+        Meshlet m{};
+        m.indexOffset = indexOffset;
+        m.indexCount = indexCount;
+        m.baseVertex = baseVertex;
+
+        // 바운딩 구: AABB 중심 + 최대 거리
+        glm::vec3 bmin = vertices[meshletVertices[0]].pos, bmax = bmin;
+        for (unsigned int v : meshletVertices) {
+            bmin = glm::min(bmin, vertices[v].pos);
+            bmax = glm::max(bmax, vertices[v].pos);
+        }
+        glm::vec3 center = (bmin + bmax) * 0.5f;
+        float radius = 0.0f;
+        for (unsigned int v : meshletVertices)
+            radius = std::max(radius, glm::length(vertices[v].pos - center));
+
+        // 법선 콘: 면 법선 평균을 축으로, 축에서 가장 먼 면 법선까지의 각으로 cutoff
+        glm::vec3 axis(0.0f);
+        for (uint32_t i = 0; i < indexCount; i += 3)
+            axis += faceNormal(tris + i);
+        float axisLen = glm::length(axis);
+        float minDot = 1.0f;
+        if (axisLen > 0.0f) {
+            axis /= axisLen;
+            for (uint32_t i = 0; i < indexCount; i += 3) {
+                glm::vec3 n = faceNormal(tris + i);
+                if (n != glm::vec3(0.0f)) minDot = std::min(minDot, glm::dot(n, axis));
+            }
+        }
+        // 콘이 반구에 가까우면 (minDot <= 0.1) 뒷면 컬링을 하지 않는다
+        float cutoff = (axisLen <= 0.0f || minDot <= 0.1f) ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+
+        for (int k = 0; k < 3; ++k) {
+            m.center[k] = center[k];
+            m.coneAxis[k] = axis[k];
+        }
+        m.radius = radius;
+        m.coneCutoff = cutoff;
+        objData.meshlets.push_back(m);
+    };
+
+    // LOD 구간과 청크의 교집합마다 따로 만든다 (클러스터가 LOD 나 청크 경계를 넘지 않음)
+    std::vector<MeshChunk> segments;
+    for (const MeshLod& range : indexRanges(objData)) {
+        for (const MeshChunk& chunk : objData.chunks) {
+            uint32_t begin = std::max(range.indexOffset, chunk.indexOffset);
+            uint32_t end = std::min(range.indexOffset + range.indexCount, chunk.indexOffset + chunk.indexCount);
+            if (begin < end)
+                segments.push_back({begin, end - begin, chunk.baseVertex, chunk.vertexCount});
+        }
+    }
+
+    uint32_t meshletId = 0;
+    size_t indexSize = indexFormatSize(objData.indexFormat);
+    for (const MeshChunk& chunk : segments) {
+        const unsigned int* chunkIndices = indices.data() + chunk.indexOffset;
+        uint32_t triCount = chunk.indexCount / 3;
+        if (triCount == 0) continue;
+
+        // 정점 -> 삼각형 인접 리스트 (CSR, 청크 로컬 정점 번호)
+        std::vector<uint32_t> adjOffset(chunk.vertexCount + 1, 0);
+        for (uint32_t i = 0; i < triCount * 3; ++i)
+            adjOffset[chunkIndices[i] - chunk.baseVertex + 1]++;
+        for (uint32_t v = 0; v < chunk.vertexCount; ++v)
+            adjOffset[v + 1] += adjOffset[v];
+        std::vector<uint32_t> adjTris(triCount * 3);
+        std::vector<uint32_t> fill(adjOffset.begin(), adjOffset.end() - 1);
+        for (uint32_t i = 0; i < triCount * 3; ++i)
+            adjTris[fill[chunkIndices[i] - chunk.baseVertex]++] = i / 3;
+
+        std::vector<glm::vec3> triNormals(triCount), triCenters(triCount);
+        for (uint32_t t = 0; t < triCount; ++t) {
+            const unsigned int* tri = chunkIndices + t * 3;
+            triNormals[t] = faceNormal(tri);
+            triCenters[t] = (vertices[tri[0]].pos + vertices[tri[1]].pos + vertices[tri[2]].pos) / 3.0f;
+        }
+
+        std::vector<char> emitted(triCount, 0);
+        std::vector<unsigned int> order;
+        order.reserve(triCount * 3);
+        uint32_t seedCursor = 0;
+
+        while (order.size() < (size_t)triCount * 3) {
+            while (emitted[seedCursor]) seedCursor++;
+            uint32_t meshletStart = (uint32_t)order.size();
+            glm::vec3 centroidSum(0.0f), axisSum(0.0f);
+            float scale = 0.0f; // 거리 정규화용, 첫 삼각형 크기 기준
+            uint32_t tri = seedCursor, triangles = 0;
+
+            while (tri != kUnused) {
+                const unsigned int* t = chunkIndices + tri * 3;
+                for (int k = 0; k < 3; ++k) {
+                    if (stamp[t[k]] != meshletId) {
+                        stamp[t[k]] = meshletId;
+                        meshletVertices.push_back(t[k]);
+                    }
+                    order.push_back(t[k]);
+                }
+                emitted[tri] = 1;
+                centroidSum += triCenters[tri];
+                axisSum += triNormals[tri];
+                if (scale == 0.0f)
+                    scale = std::max(glm::length(vertices[t[1]].pos - vertices[t[0]].pos), 1e-6f);
+                if (++triangles == kMeshletMaxTriangles) break;
+
+                // 다음 삼각형: 새 정점 수 -> (거리 - 법선 일치) 순으로 비교
+                glm::vec3 centroid = centroidSum / (float)triangles;
+                float axisLen = glm::length(axisSum);
+                glm::vec3 axis = axisLen > 0.0f ? axisSum / axisLen : glm::vec3(0.0f);
+                uint32_t best = kUnused;
+                int bestNew = 4;
+                float bestScore = 0.0f;
+                for (unsigned int v : meshletVertices) {
+                    uint32_t local = v - chunk.baseVertex;
+                    for (uint32_t a = adjOffset[local]; a < adjOffset[local + 1]; ++a) {
+                        uint32_t c = adjTris[a];
+                        if (emitted[c]) continue;
+                        const unsigned int* ct = chunkIndices + c * 3;
+                        int newVertices = (stamp[ct[0]] != meshletId) + (stamp[ct[1]] != meshletId) +
+                                          (stamp[ct[2]] != meshletId);
+                        if (meshletVertices.size() + newVertices > kMeshletMaxVertices) continue;
+                        float score = glm::length(triCenters[c] - centroid) / scale -
+                                      glm::dot(triNormals[c], axis);
+                        if (newVertices < bestNew || (newVertices == bestNew && score < bestScore)) {
+                            best = c;
+                            bestNew = newVertices;
+                            bestScore = score;
+                        }
+                    }
+                }
+                tri = best;
+            }
+
+            closeMeshlet(order.data() + meshletStart, chunk.indexOffset + meshletStart,
+                         (uint32_t)order.size() - meshletStart, chunk.baseVertex);
+            meshletVertices.clear();
+            meshletId++;
+        }
+
+        // 클러스터 순서로 인덱스 구간을 다시 쓴다
+        std::copy(order.begin(), order.end(), indices.begin() + chunk.indexOffset);
+        std::vector<unsigned char> packed;
+        storeIndices(packed, objData.indexFormat, order.data(), order.size(), chunk.baseVertex);
+        std::memcpy(objData.packedIndices.data() + chunk.indexOffset * indexSize, packed.data(), packed.size());
+    }
+
+    // 클러스터는 인덱스 순서대로 만들어졌으므로 LOD 마다 연속 구간이다
+    for (MeshLod& lod : objData.lods) {
+        lod.meshletOffset = (uint32_t)objData.meshlets.size();
+        lod.meshletCount = 0;
+        for (uint32_t i = 0; i < objData.meshlets.size(); ++i) {
+            if (objData.meshlets[i].indexOffset >= lod.indexOffset) {
+                lod.meshletOffset = i;
+                break;
+            }
+        }
+        for (uint32_t i = lod.meshletOffset; i < objData.meshlets.size() &&
+             objData.meshlets[i].indexOffset < lod.indexOffset + lod.indexCount; ++i)
+            lod.meshletCount++;
+    }
+
+    std::cout << "Meshlets: " << objData.meshlets.size() << " clusters ("
+              << (objData.meshlets.empty() ? 0.0 : indices.size() / 3.0 / objData.meshlets.size())
+              << " triangles avg)\n";
+}
+
+// mvp 는 모델 공간 -> 클립 공간, cameraPos 는 모델 공간 카메라 위치.
+// 살아남은 클러스터 번호를 visible 에 담는다.
+void cullMeshlets(const Meshlet* meshlets, size_t count, const glm::mat4& mvp,
+                  const glm::vec3& cameraPos, std::vector<uint32_t>& visible) {
+    // 클립 행렬에서 절두체 평면 6개 추출 (Gribb/Hartmann), 모델 공간 기준
+    glm::vec4 planes[6];
+    glm::mat4 m = glm::transpose(mvp);
+    planes[0] = m[3] + m[0];
+    planes[1] = m[3] - m[0];
+    planes[2] = m[3] + m[1];
+    planes[3] = m[3] - m[1];
+    planes[4] = m[3] + m[2];
+    planes[5] = m[3] - m[2];
+    for (glm::vec4& p : planes)
+        p /= glm::length(glm::vec3(p));
+
+    visible.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const Meshlet& ml = meshlets[i];
+        glm::vec3 center(ml.center[0], ml.center[1], ml.center[2]);
+
+        bool outside = false;
+        for (const glm::vec4& p : planes) {
+            if (glm::dot(glm::vec3(p), center) + p.w < -ml.radius) {
+                outside = true;
+                break;
+            }
+        }
+        if (outside) continue;
+
+        // 클러스터의 모든 면이 카메라 반대쪽을 향하면 버린다
+        glm::vec3 axis(ml.coneAxis[0], ml.coneAxis[1], ml.coneAxis[2]);
+        glm::vec3 toCluster = center - cameraPos;
+        if (glm::dot(toCluster, axis) >= ml.coneCutoff * glm::length(toCluster) + ml.radius)
+            continue;
+
+        visible.push_back((uint32_t)i);
+    }
+}
+
+// ===== Vertex Quantization =====
+// 위치는 AABB 기준 snorm16, 법선은 옥타헤드럴 2 x snorm16, UV 는 half float 로 줄여
+// 정점을 32바이트에서 16바이트로 만든다. 복원은 셰이더에서 bounds 유니폼으로 한다.
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFFu) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (((bits >> 23) & 0xFFu) == 0xFFu)                  // Inf / NaN
+        return (uint16_t)(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+    if (exponent >= 31)                                   // 오버플로 -> Inf
+        return (uint16_t)(sign | 0x7C00u);
+    if (exponent <= 0) {                                  // 비정규화 수 또는 0
+        if (exponent < -10) return (uint16_t)sign;
+        mantissa |= 0x800000u;
+        uint32_t shift = (uint32_t)(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) half++;
+        return (uint16_t)(sign | half);
+    }
+    uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) half++; // 올림이 지수로 넘어가도 맞다
+    return (uint16_t)half;
+}
+
+float halfToFloat(uint16_t half) {
+    uint32_t sign = (uint32_t)(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400u)) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+inline int16_t quantizeSnorm16(float value) {
+    value = std::max(-1.0f, std::min(1.0f, value));
+    return (int16_t)std::lround(value * 32767.0f);
+}
+
+inline float signNotZero(float value) { return value >= 0.0f ? 1.0f : -1.0f; }
+
+glm::vec2 octahedralEncode(const glm::vec3& n) {
+    float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+    if (l1 == 0.0f) return glm::vec2(0.0f);
+    glm::vec2 p(n.x / l1, n.y / l1);
+    if (n.z < 0.0f)
+        p = glm::vec2((1.0f - std::fabs(p.y)) * signNotZero(p.x),
+                      (1.0f - std::fabs(p.x)) * signNotZero(p.y));
+    return p;
+}
+
+glm::vec3 octahedralDecode(const glm::vec2& e) {
+    glm::vec3 n(e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y));
+    if (n.z < 0.0f) {
+        float x = n.x;
+        n.x = (1.0f - std::fabs(n.y)) * signNotZero(x);
+        n.y = (1.0f - std::fabs(x)) * signNotZero(n.y);
+    }
+    return glm::normalize(n);
+}
+
+// 셰이더와 같은 방식으로 snorm16 -> [-1, 1]
+inline float dequantizeSnorm16(int16_t value) { return std::max(-1.0f, value / 32767.0f); }
+
+// 양자화 기준: AABB 중심과 반 크기 (납작한 축은 1 로 둬서 0 나누기를 피한다)
+void quantizationFrame(const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                       glm::vec3& center, glm::vec3& extent) {
+    center = (boundsMin + boundsMax) * 0.5f;
+    extent = (boundsMax - boundsMin) * 0.5f;
+    for (int i = 0; i < 3; ++i)
+        if (extent[i] <= 0.0f) extent[i] = 1.0f;
+}
+
+void quantizeVertices(ObjData& objData) {
+    glm::vec3 center, extent;
+    quantizationFrame(objData.boundsMin, objData.boundsMax, center, extent);
+
+    double posErrorSum = 0.0, norErrorSum = 0.0, texErrorSum = 0.0;
+    float posErrorMax = 0.0f, norErrorMax = 0.0f, texErrorMax = 0.0f;
+    size_t normalCount = 0;
+
+    objData.packedVertices.resize(objData.vertices.size());
+    for (size_t i = 0; i < objData.vertices.size(); ++i) {
+        const Vertex& v = objData.vertices[i];
+        PackedVertex& q = objData.packedVertices[i];
+
+        glm::vec3 rel = (v.pos - center) / extent;
+        for (int k = 0; k < 3; ++k) q.pos[k] = quantizeSnorm16(rel[k]);
+        q.pos[3] = 0;
+
+        glm::vec2 oct = octahedralEncode(v.nor);
+        q.nor[0] = quantizeSnorm16(oct.x);
+        q.nor[1] = quantizeSnorm16(oct.y);
+
+        q.tex[0] = floatToHalf(v.tex.x);
+        q.tex[1] = floatToHalf(v.tex.y);
+
+        // --- 오차 측정 ---
+        glm::vec3 pos = center + glm::vec3(dequantizeSnorm16(q.pos[0]), dequantizeSnorm16(q.pos[1]),
+                                           dequantizeSnorm16(q.pos[2])) * extent;
+        float posError = glm::length(pos - v.pos);
+        posErrorSum += posError;
+        posErrorMax = std::max(posErrorMax, posError);
+
+        float len = glm::length(v.nor);
+        if (len > 0.0f) {
+            glm::vec3 nor = octahedralDecode(glm::vec2(dequantizeSnorm16(q.nor[0]), dequantizeSnorm16(q.nor[1])));
+            float cosAngle = std::max(-1.0f, std::min(1.0f, glm::dot(nor, v.nor / len)));
+            float norError = glm::degrees(std::acos(cosAngle));
+            norErrorSum += norError;
+            norErrorMax = std::max(norErrorMax, norError);
+            normalCount++;
+        }
+
+        glm::vec2 tex(halfToFloat(q.tex[0]), halfToFloat(q.tex[1]));
+        float texError = glm::length(tex - v.tex);
+        texErrorSum += texError;
+        texErrorMax = std::max(texErrorMax, texError);
+    }
+
+    objData.vertexFormat = VertexFormat::Quantized;
+
+    size_t count = std::max<size_t>(objData.vertices.size(), 1);
+    std::cout << "Quantized vertices: " << sizeof(Vertex) << " -> " << sizeof(PackedVertex) << " bytes\n";
+    std::cout << "  Position error: avg " << posErrorSum / count << ", max " << posErrorMax
+              << " (extent " << glm::length(extent) << ")\n";
+    std::cout << "  Normal error  : avg " << norErrorSum / std::max<size_t>(normalCount, 1)
+              << " deg, max " << norErrorMax << " deg\n";
+    std::cout << "  UV error      : avg " << texErrorSum / count << ", max " << texErrorMax << "\n";
+}
+
+// ===== Binary Mesh Cache (.meshbin) =====
+// 최초 loadOBJ 결과를 OBJ 옆에 저장해 두고, 다음 실행부터는 파일을 mmap 해서
+// 정점/인덱스 배열을 그대로 glBufferData 에 넘긴다.
+const char kMeshCacheMagic[8] = {'M', 'E', 'S', 'H', 'B', 'I', 'N', '\0'};
+const uint32_t kMeshCacheVersion = 11;
+
+struct MeshCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t vertexStride;   // 정점 크기 - 정점 레이아웃이 바뀌면 무효
+    uint32_t vertexFormat;   // VertexFormat
+    uint32_t indexFormat;    // IndexFormat
+    uint64_t sourceSize;
+    int64_t  sourceMtime;
+    uint64_t sourceHash;
+    uint64_t vertexCount;
+    uint64_t indexCount;
+    uint32_t chunkCount;
+    uint32_t hasTangents;    // 1 이면 정점 뒤에 vec4 탄젠트 스트림
+    uint64_t vertexOffset;
+    uint64_t tangentOffset;
+    uint64_t chunkOffset;
+    uint64_t meshletCount;
+    uint64_t meshletOffset;
+    uint64_t lodCount;
+    uint64_t lodOffset;
+    uint64_t submeshCount;
+    uint64_t submeshOffset;
+    uint64_t indexOffset;
+    uint64_t materialCount;  // 인덱스 뒤: 재질마다 Kd[3], 이름 길이, 텍스처 경로 길이 (uint32), 문자열들
+    uint64_t materialOffset;
+    float boundsMin[3];
+    float boundsMax[3];
+    float sphereCenter[3];
+    float sphereRadius;
+};
+
+// 64비트 단위 FNV-1a 변형. 암호학적 용도가 아니라 원본 변경 감지용.
+uint64_t hashBytes(const char* data, size_t size) {
+    uint64_t h = 14695981039346656037ull;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ word) * 1099511628211ull;
+        h ^= h >> 29;
+    }
+    for (; i < size; ++i)
+        h = (h ^ (unsigned char)data[i]) * 1099511628211ull;
+    return h;
+}
+
+std::string meshCachePath(const std::string& objPath) {
+    return std::filesystem::path(objPath).replace_extension(".meshbin").string();
+}
+
+bool sourceFileStamp(const std::string& path, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    mtime = (int64_t)time.time_since_epoch().count();
+    return true;
+}
+
+bool hashSourceFile(const std::string& path, uint64_t& hash) {
+    MappedFile source;
+    if (!source.Open(path)) return false;
+    hash = hashBytes(source.Data(), source.Size());
+    return true;
+}
+
+// 캐시에서 매핑된 메시. view 의 포인터는 file 이 열려 있는 동안만 유효하다.
+struct MeshCache {
+    MappedFile file;
+    const MeshCacheHeader* header = nullptr;
+    std::vector<Material> materials; // 가변 길이라 매핑하지 않고 읽어 둔다
+    MeshView view;
+};
+
+// packIndices() 를 거친 ObjData 를 저장한다
+bool writeMeshCache(const std::string& objPath, const ObjData& objData) {
+    MeshCacheHeader header{};
+    memcpy(header.magic, kMeshCacheMagic, sizeof(header.magic));
+    header.version = kMeshCacheVersion;
+    header.vertexFormat = (uint32_t)objData.vertexFormat;
+    header.vertexStride = (uint32_t)vertexFormatSize(objData.vertexFormat);
+    if (!sourceFileStamp(objPath, header.sourceSize, header.sourceMtime) ||
+        !hashSourceFile(objPath, header.sourceHash))
+        return false;
+    header.vertexCount = objData.vertices.size();
+    header.indexCount = objData.indices.size();
+    header.indexFormat = (uint32_t)objData.indexFormat;
+    header.chunkCount = (uint32_t)objData.chunks.size();
+    header.vertexOffset = (sizeof(MeshCacheHeader) + 15) & ~(uint64_t)15;
+    header.hasTangents = objData.tangents.empty() ? 0 : 1;
+    header.tangentOffset = header.vertexOffset + header.vertexCount * header.vertexStride;
+    header.chunkOffset = header.tangentOffset + (header.hasTangents ? header.vertexCount * sizeof(glm::vec4) : 0);
+    header.meshletCount = objData.meshlets.size();
+    header.meshletOffset = header.chunkOffset + header.chunkCount * sizeof(MeshChunk);
+    header.lodCount = objData.lods.size();
+    header.lodOffset = header.meshletOffset + header.meshletCount * sizeof(Meshlet);
+    header.submeshCount = objData.submeshes.size();
+    header.submeshOffset = header.lodOffset + header.lodCount * sizeof(MeshLod);
+    header.indexOffset = header.submeshOffset + header.submeshCount * sizeof(Submesh);
+    header.materialCount = objData.materials.size();
+    header.materialOffset = header.indexOffset + objData.packedIndices.size();
+    for (int i = 0; i < 3; ++i) {
+        header.boundsMin[i] = objData.boundsMin[i];
+        header.boundsMax[i] = objData.boundsMax[i];
+        header.sphereCenter[i] = objData.sphereCenter[i];
+    }
+    header.sphereRadius = objData.sphereRadius;
+
+    // 중간에 실패해도 깨진 캐시가 남지 않도록 임시 파일에 쓰고 교체
+    std::string cachePath = meshCachePath(objPath);
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        const char padding[16] = {};
+        out.write((const char*)&header, sizeof(header));
+        out.write(padding, (std::streamsize)(header.vertexOffset - sizeof(header)));
+        MeshView view = makeMeshView(objData);
+        out.write((const char*)view.vertices, (std::streamsize)(header.vertexCount * header.vertexStride));
+        if (header.hasTangents)
+            out.write((const char*)view.tangents, (std::streamsize)(header.vertexCount * sizeof(glm::vec4)));
+        out.write((const char*)objData.chunks.data(), (std::streamsize)(header.chunkCount * sizeof(MeshChunk)));
+        out.write((const char*)objData.meshlets.data(), (std::streamsize)(header.meshletCount * sizeof(Meshlet)));
+        out.write((const char*)objData.lods.data(), (std::streamsize)(header.lodCount * sizeof(MeshLod)));
+        out.write((const char*)objData.submeshes.data(), (std::streamsize)(header.submeshCount * sizeof(Submesh)));
+        out.write((const char*)objData.packedIndices.data(), (std::streamsize)objData.packedIndices.size());
+        for (const Material& m : objData.materials) {
+            uint32_t lengths[2] = {(uint32_t)m.name.size(), (uint32_t)m.diffuseMap.size()};
+            out.write((const char*)&m.diffuse[0], sizeof(float) * 3);
+            out.write((const char*)lengths, sizeof(lengths));
+            out.write(m.name.data(), (std::streamsize)m.name.size());
+            out.write(m.diffuseMap.data(), (std::streamsize)m.diffuseMap.size());
+        }
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tempPath);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    std::cout << "Wrote mesh cache: " << cachePath << "\n";
+    return true;
+}
+
+// 캐시가 없거나 원본 또는 요청한 정점 포맷/클러스터/LOD/strict16 과 맞지 않으면 false. 크기와 수정 시각이
+// 같으면 바로 사용하고, 수정 시각만 다르면 (복사, checkout 등) 원본 해시를 비교한다.
+// strict16 은 결과로 판단한다: 65536 정점 이하면 두 경우가 같고, 넘으면 strict16 만 16비트 청크 여러 개다.
+bool openMeshCache(const std::string& objPath, MeshCache& cache, VertexFormat vertexFormat, bool tangents,
+                   bool meshlets, bool lods, bool strict16) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    if (!sourceFileStamp(objPath, sourceSize, sourceMtime)) return false;
+
+    std::string cachePath = meshCachePath(objPath);
+    if (!cache.file.Open(cachePath)) return false;
+    if (cache.file.Size() < sizeof(MeshCacheHeader)) return false;
+
+    const MeshCacheHeader* header = (const MeshCacheHeader*)cache.file.Data();
+    if (memcmp(header->magic, kMeshCacheMagic, sizeof(header->magic)) != 0 ||
+        header->version != kMeshCacheVersion ||
+        header->vertexFormat != (uint32_t)vertexFormat ||
+        header->vertexStride != vertexFormatSize(vertexFormat) ||
+        header->hasTangents != (tangents ? 1u : 0u) ||
+        (header->meshletCount != 0) != meshlets ||
+        (header->lodCount != 0) != lods ||
+        (strict16 ? header->indexFormat == (uint32_t)IndexFormat::UInt32 : header->chunkCount > 1) ||
+        header->sourceSize != sourceSize)
+        return false;
+
+    if (header->indexFormat > (uint32_t)IndexFormat::UInt32 ||
+        header->vertexOffset + header->vertexCount * header->vertexStride > header->tangentOffset ||
+        header->tangentOffset + (header->hasTangents ? header->vertexCount * sizeof(glm::vec4) : 0) > header->chunkOffset ||
+        header->chunkOffset + header->chunkCount * sizeof(MeshChunk) > header->meshletOffset ||
+        header->meshletOffset + header->meshletCount * sizeof(Meshlet) > header->lodOffset ||
+        header->lodOffset + header->lodCount * sizeof(MeshLod) > header->submeshOffset ||
+        header->submeshOffset + header->submeshCount * sizeof(Submesh) > header->indexOffset ||
+        header->indexOffset + header->indexCount * indexFormatSize((IndexFormat)header->indexFormat) > header->materialOffset ||
+        header->materialOffset > cache.file.Size())
+        return false;
+
+    if (header->sourceMtime != sourceMtime) {
+        uint64_t sourceHash;
+        if (!hashSourceFile(objPath, sourceHash) || sourceHash != header->sourceHash)
+            return false;
+    }
+
+    // 재질 테이블 (잘려 있으면 캐시 전체를 무효로)
+    const char* cursor = cache.file.Data() + header->materialOffset;
+    const char* fileEnd = cache.file.Data() + cache.file.Size();
+    cache.materials.clear();
+    for (uint64_t i = 0; i < header->materialCount; ++i) {
+        float diffuse[3];
+        uint32_t lengths[2];
+        if ((size_t)(fileEnd - cursor) < sizeof(diffuse) + sizeof(lengths)) return false;
+        memcpy(diffuse, cursor, sizeof(diffuse));
+        memcpy(lengths, cursor + sizeof(diffuse), sizeof(lengths));
+        cursor += sizeof(diffuse) + sizeof(lengths);
+        if ((size_t)(fileEnd - cursor) < (size_t)lengths[0] + lengths[1]) return false;
+        Material m;
+        m.diffuse = glm::vec3(diffuse[0], diffuse[1], diffuse[2]);
+        m.name.assign(cursor, lengths[0]);
+        m.diffuseMap.assign(cursor + lengths[0], lengths[1]);
+        cursor += lengths[0] + lengths[1];
+        cache.materials.push_back(std::move(m));
+    }
+
+    cache.header = header;
+    cache.view.vertices = cache.file.Data() + header->vertexOffset;
+    cache.view.vertexCount = (size_t)header->vertexCount;
+    cache.view.vertexFormat = vertexFormat;
+    if (header->hasTangents)
+        cache.view.tangents = (const glm::vec4*)(cache.file.Data() + header->tangentOffset);
+    cache.view.boundsMin = glm::vec3(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]);
+    cache.view.boundsMax = glm::vec3(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]);
+    cache.view.sphereCenter = glm::vec3(header->sphereCenter[0], header->sphereCenter[1], header->sphereCenter[2]);
+    cache.view.sphereRadius = header->sphereRadius;
+    cache.view.indices = cache.file.Data() + header->indexOffset;
+    cache.view.indexCount = (size_t)header->indexCount;
+    cache.view.indexFormat = (IndexFormat)header->indexFormat;
+    cache.view.chunks = (const MeshChunk*)(cache.file.Data() + header->chunkOffset);
+    cache.view.chunkCount = header->chunkCount;
+    cache.view.meshlets = (const Meshlet*)(cache.file.Data() + header->meshletOffset);
+    cache.view.meshletCount = (size_t)header->meshletCount;
+    if (header->lodCount)
+        cache.view.lods = (const MeshLod*)(cache.file.Data() + header->lodOffset);
+    cache.view.lodCount = (size_t)header->lodCount;
+    cache.view.submeshes = (const Submesh*)(cache.file.Data() + header->submeshOffset);
+    cache.view.submeshCount = (size_t)header->submeshCount;
+    cache.view.materials = cache.materials.data();
+    cache.view.materialCount = cache.materials.size();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Loaded mesh cache: " << cachePath << "\n";
+    std::cout << "  Vertices : " << header->vertexCount << "\n";
+    std::cout << "  Indices  : " << header->indexCount << " ("
+              << indexFormatSize(cache.view.indexFormat) * 8 << "-bit, "
+              << header->chunkCount << " chunk" << (header->chunkCount > 1 ? "s" : "") << ")\n";
+    if (header->lodCount)
+        std::cout << "  LODs     : " << header->lodCount << "\n";
+    if (header->materialCount)
+        std::cout << "  Materials: " << header->materialCount << " (" << header->submeshCount << " submeshes)\n";
+    std::cout << "  Opened in: " << seconds * 1000.0 << " ms\n";
+    return true;
+}
+
+// ===== Texture Loader =====
+// 디코딩(stb_image, JPEG 은 decodeJpegParallel)과 GL 업로드를 나눠서 디코딩은 작업 스레드에서 할 수 있게 한다
+struct MipLevel {
+    int width, height;
+    size_t offset;   // 0 레벨부터 이어 붙였을 때의 바이트 위치 (PBO 안 위치와 같다)
+};
+
+// 압축 설정 (--compress-textures, --bc7) 과 실제 블록 포맷 (채널 수로 정해진다)
+enum class TextureCompression { None, BCn, BC7 };
+enum class TextureCodec : uint32_t { None, BC1, BC3, BC4, BC5, BC7 };
+
+struct DecodedImage {
+    unsigned char* data = nullptr;         // 0 레벨 (stbi 소유, stbi_image_free)
+    int width = 0, height = 0, channels = 0;
+    std::vector<MipLevel> levels;          // buildMipChain() 뒤: 0 레벨부터 1x1 까지
+    std::vector<unsigned char> mipData;    // 1 레벨부터 이어 붙인 픽셀 (행 사이 여백 없음)
+    TextureCodec codec = TextureCodec::None;
+    std::vector<unsigned char> blocks;     // codec 이 있으면 모든 레벨의 블록 (data/mipData 는 비어 있다)
+};
+
+bool imageLoaded(const DecodedImage& image) {
+    return image.data || !image.blocks.empty();
+}
+
+// 0 레벨부터 마지막 레벨까지의 바이트 수
+size_t imageBytes(const DecodedImage& image) {
+    if (image.codec != TextureCodec::None) return image.blocks.size();
+    if (image.levels.empty()) return (size_t)image.width * image.height * image.channels;
+    const MipLevel& last = image.levels.back();
+    return last.offset + (size_t)last.width * last.height * image.channels;
+}
+
+// ===== Parallel JPEG Decode =====
+// stbi_load 와 같은 픽셀을 내는 JPEG 디코더. stb_image 의 JPEG 구현(같은 번역 단위)에서 헤더/마커 처리,
+// 허프만 블록 디코딩, IDCT/업샘플/YCbCr 커널을 그대로 쓰고 단계마다 코어를 나눠 쓴다.
+//  1) 엔트로피 디코딩: restart 간격(DRI)이 있으면 RSTn 마커 위치로 스캔을 잘라 스레드마다 stbi__jpeg
+//     복사본으로 푼다. 없으면 (progressive 포함) 한 스레드가 순서대로 푼다. 둘 다 계수만 남긴다.
+//  2) 역양자화 + IDCT: 블록 행 단위 병렬.
+//  3) 업샘플 + 색 변환: 출력 행 단위 병렬 (업샘플러 상태는 시작 행까지 건너뛰어 맞춘다).
+// stb_image.h 는 고치지 않았으므로 stbi_load 를 쓰는 다른 코드는 그대로다. 4 채널(CMYK/YCCK)이나
+// 손상된 스트림이면 nullptr 을 돌려주고, 호출자가 stbi_load_from_memory 로 다시 읽는다.
+const int kJpegIdctGrainRows = 8;     // 스레드 하나가 맡는 최소 블록 행
+const int kJpegColorGrainRows = 64;   // 스레드 하나가 맡는 최소 출력 행
+
+// baseline 계수 버퍼 (progressive 는 stb 가 raw_coeff 로 잡는다). IDCT 커널이 16 바이트 정렬을 요구한다.
+struct JpegCoefficients {
+    std::vector<short> storage[4];
+
+    void Allocate(stbi__jpeg& j) {
+        for (int n = 0; n < j.s->img_n; ++n) {
+            auto& comp = j.img_comp[n];
+            comp.coeff_w = comp.w2 / 8;
+            comp.coeff_h = comp.h2 / 8;
+            storage[n].assign((size_t)comp.w2 * comp.h2 + 8, 0);
+            comp.coeff = (short*)(((uintptr_t)storage[n].data() + 15) & ~(uintptr_t)15);
+        }
+    }
+};
+
+// stbi__parse_entropy_coded_data 의 baseline 루프와 같지만 MCU [first, last) 만 풀고, IDCT 대신 (이미
+// 역양자화된) 계수를 img_comp[].coeff 에 남긴다. restart 구간 처리도 stb 와 같다.
+bool decodeJpegMcus(stbi__jpeg* z, int first, int last) {
+    stbi__jpeg_reset(z);
+    for (int mcu = first; mcu < last; ++mcu) {
+        if (z->scan_n == 1) {
+            // 비인터리브: 블록 하나가 MCU
+            auto& comp = z->img_comp[z->order[0]];
+            int n = z->order[0];
+            int blocksX = (comp.x + 7) >> 3;
+            short* data = comp.coeff + 64 * ((mcu % blocksX) + (mcu / blocksX) * comp.coeff_w);
+            if (!stbi__jpeg_decode_block(z, data, z->huff_dc + comp.hd, z->huff_ac + comp.ha, z->fast_ac[comp.ha], n,
+                                         z->dequant[comp.tq]))
+                return false;
+        } else {
+            int mcuX = mcu % z->img_mcu_x, mcuY = mcu / z->img_mcu_x;
+            for (int k = 0; k < z->scan_n; ++k) {
+                int n = z->order[k];
+                auto& comp = z->img_comp[n];
+                for (int y = 0; y < comp.v; ++y) {
+                    for (int x = 0; x < comp.h; ++x) {
+                        int blockX = mcuX * comp.h + x, blockY = mcuY * comp.v + y;
+                        short* data = comp.coeff + 64 * (blockX + blockY * comp.coeff_w);
+                        if (!stbi__jpeg_decode_block(z, data, z->huff_dc + comp.hd, z->huff_ac + comp.ha,
+                                                     z->fast_ac[comp.ha], n, z->dequant[comp.tq]))
+                            return false;
+                    }
+                }
+            }
+        }
+        if (--z->todo <= 0) {
+            if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
+            if (!STBI__RESTART(z->marker)) return true; // stb 처럼 나머지는 비워 둔다
+            stbi__jpeg_reset(z);
+        }
+    }
+    return true;
+}
+
+// 현재 위치(스캔 헤더 바로 뒤)부터 엔트로피 데이터를 훑어 restart 구간 시작 위치들과 스캔 끝(다음 마커의
+// 0xFF)을 찾는다. 구간 수가 MCU 수와 맞지 않으면 false (순서대로 푼다).
+bool findJpegRestartSegments(const stbi__jpeg& j, int mcuCount, std::vector<const stbi_uc*>& segments,
+                             const stbi_uc*& scanEnd) {
+    const stbi_uc* p = j.s->img_buffer;
+    const stbi_uc* end = j.s->img_buffer_end;
+    segments.assign(1, p);
+    scanEnd = end;
+    while (p + 1 < end) {
+        if (p[0] != 0xFF || p[1] == 0x00) { p += p[0] == 0xFF ? 2 : 1; continue; }
+        if (p[1] == 0xFF) { ++p; continue; } // 채움 바이트
+        if (!STBI__RESTART(p[1])) { scanEnd = p; break; }
+        segments.push_back(p + 2);
+        p += 2;
+    }
+    // 마지막 구간 뒤에 RST 가 붙는 인코더도 있다
+    if (segments.size() > 1 && segments.back() == scanEnd) segments.pop_back();
+    return (int)segments.size() == (mcuCount + j.restart_interval - 1) / j.restart_interval;
+}
+
+// 스캔 하나의 엔트로피 데이터를 푼다. 끝나면 stbi__decode_jpeg_image 처럼 j.marker 나 스트림 위치가
+// 스캔 뒤의 마커를 가리킨다.
+bool decodeJpegScan(stbi__jpeg& j) {
+    if (j.progressive) return stbi__parse_entropy_coded_data(&j) != 0;
+
+    int mcuCount = j.scan_n == 1
+        ? ((j.img_comp[j.order[0]].x + 7) >> 3) * ((j.img_comp[j.order[0]].y + 7) >> 3)
+        : j.img_mcu_x * j.img_mcu_y;
+    std::vector<const stbi_uc*> segments;
+    const stbi_uc* scanEnd = nullptr;
+    if (j.restart_interval <= 0 || !findJpegRestartSegments(j, mcuCount, segments, scanEnd) || segments.size() < 2)
+        return decodeJpegMcus(&j, 0, mcuCount);
+
+    std::atomic<bool> failed(false);
+    parallelRanges(segments.size(), 1, [&](size_t begin, size_t end) {
+        // 허프만 테이블/양자화표는 복사본에서 읽기만 하고, 계수는 구간마다 겹치지 않는 블록에 쓴다
+        std::unique_ptr<stbi__jpeg> worker(new stbi__jpeg(j));
+        stbi__context context;
+        stbi__start_mem(&context, segments[begin], (int)(j.s->img_buffer_end - segments[begin]));
+        worker->s = &context;
+        int first = (int)begin * j.restart_interval;
+        int last = std::min(mcuCount, (int)end * j.restart_interval);
+        if (!decodeJpegMcus(worker.get(), first, last)) failed = true;
+    });
+    j.s->img_buffer = (stbi_uc*)scanEnd;
+    j.marker = STBI__MARKER_none;
+    return !failed;
+}
+
+// stbi__decode_jpeg_image 의 마커 루프. progressive/baseline 모두 계수까지만 만든다.
+bool decodeJpegCoefficients(stbi__jpeg& j, JpegCoefficients& coefficients) {
+    for (int n = 0; n < 4; ++n) {
+        j.img_comp[n].raw_data = nullptr;
+        j.img_comp[n].raw_coeff = nullptr;
+    }
+    j.restart_interval = 0;
+    if (!stbi__decode_jpeg_header(&j, STBI__SCAN_load)) return false;
+    if (j.s->img_n == 4) return false; // CMYK/YCCK 는 stb 에 맡긴다
+    if (!j.progressive) coefficients.Allocate(j);
+
+    int m = stbi__get_marker(&j);
+    while (!stbi__EOI(m)) {
+        if (stbi__SOS(m)) {
+            if (!stbi__process_scan_header(&j)) return false;
+            if (!decodeJpegScan(j)) return false;
+            if (j.marker == STBI__MARKER_none) j.marker = stbi__skip_jpeg_junk_at_end(&j);
+            m = stbi__get_marker(&j);
+            if (STBI__RESTART(m)) m = stbi__get_marker(&j);
+        } else if (stbi__DNL(m)) {
+            int length = stbi__get16be(j.s);
+            stbi__uint32 lines = stbi__get16be(j.s);
+            if (length != 4 || lines != j.s->img_y) return false;
+            m = stbi__get_marker(&j);
+        } else {
+            if (!stbi__process_marker(&j, m)) return true;
+            m = stbi__get_marker(&j);
+        }
+    }
+    return true;
+}
+
+// 모든 성분의 블록 행을 한 목록으로 보고 나눠서 역양자화(progressive 만) + IDCT
+void idctJpegComponents(stbi__jpeg& j) {
+    int rowStart[5] = {0};
+    for (int n = 0; n < j.s->img_n; ++n) rowStart[n + 1] = rowStart[n] + ((j.img_comp[n].y + 7) >> 3);
+    parallelRanges((size_t)rowStart[j.s->img_n], kJpegIdctGrainRows, [&](size_t begin, size_t end) {
+        for (int row = (int)begin; row < (int)end; ++row) {
+            int n = 0;
+            while (row >= rowStart[n + 1]) ++n;
+            auto& comp = j.img_comp[n];
+            int blockY = row - rowStart[n];
+            int blocksX = (comp.x + 7) >> 3;
+            for (int blockX = 0; blockX < blocksX; ++blockX) {
+                short* data = comp.coeff + 64 * (blockX + blockY * comp.coeff_w);
+                if (j.progressive) stbi__jpeg_dequantize(data, j.dequant[comp.tq]);
+                j.idct_block_kernel(comp.data + comp.w2 * blockY * 8 + blockX * 8, comp.w2, data);
+            }
+        }
+    });
+}
+
+// load_jpeg_image 의 업샘플 + 색 변환 (req_comp = 0, 1/3 성분만). 행 구간마다 업샘플러와 줄 버퍼를 따로 둔다.
+void convertJpegRows(stbi__jpeg& j, stbi_uc* output, bool flipVertically) {
+    int componentCount = j.s->img_n;
+    int width = (int)j.s->img_x, height = (int)j.s->img_y;
+    bool isRgb = componentCount == 3 && (j.rgb == 3 || (j.app14_color_transform == 0 && !j.jfif));
+    parallelRanges((size_t)height, kJpegColorGrainRows, [&](size_t begin, size_t end) {
+        stbi__resample resamplers[3];
+        std::vector<stbi_uc> lineBuffers[3];
+        // stb 의 스칼라 YCbCr 커널은 픽셀마다 4 바이트째(다음 픽셀 자리)까지 쓴다. 위에서 아래로 한 줄씩 쓰는
+        // stb 에서는 다음 줄이 덮어쓰지만, 뒤집거나 구간을 나누면 이웃 줄을 망가뜨리므로 한 줄 버퍼를 거친다.
+        std::vector<stbi_uc> rgbRow((size_t)width * 3 + 1);
+        for (int k = 0; k < componentCount; ++k) {
+            stbi__resample* r = &resamplers[k];
+            lineBuffers[k].resize((size_t)width + 3);
+            r->hs = j.img_h_max / j.img_comp[k].h;
+            r->vs = j.img_v_max / j.img_comp[k].v;
+            r->ystep = r->vs >> 1;
+            r->w_lores = (width + r->hs - 1) / r->hs;
+            r->ypos = 0;
+            r->line0 = r->line1 = j.img_comp[k].data;
+            if (r->hs == 1 && r->vs == 1) r->resample = resample_row_1;
+            else if (r->hs == 1 && r->vs == 2) r->resample = stbi__resample_row_v_2;
+            else if (r->hs == 2 && r->vs == 1) r->resample = stbi__resample_row_h_2;
+            else if (r->hs == 2 && r->vs == 2) r->resample = j.resample_row_hv_2_kernel;
+            else r->resample = stbi__resample_row_generic;
+        }
+        stbi_uc* rows[3] = {nullptr, nullptr, nullptr};
+        for (size_t y = 0; y < end; ++y) {
+            bool emit = y >= begin;
+            for (int k = 0; k < componentCount; ++k) {
+                stbi__resample* r = &resamplers[k];
+                if (emit) {
+                    bool bottom = r->ystep >= (r->vs >> 1);
+                    rows[k] = r->resample(lineBuffers[k].data(), bottom ? r->line1 : r->line0,
+                                          bottom ? r->line0 : r->line1, r->w_lores, r->hs);
+                }
+                if (++r->ystep >= r->vs) {
+                    r->ystep = 0;
+                    r->line0 = r->line1;
+                    if (++r->ypos < j.img_comp[k].y) r->line1 += j.img_comp[k].w2;
+                }
+            }
+            if (!emit) continue;
+            size_t outRow = flipVertically ? (size_t)height - 1 - y : y;
+            stbi_uc* out = output + (size_t)componentCount * width * outRow;
+            if (componentCount == 1) {
+                memcpy(out, rows[0], (size_t)width);
+            } else if (isRgb) {
+                for (int x = 0; x < width; ++x, out += 3) {
+                    out[0] = rows[0][x];
+                    out[1] = rows[1][x];
+                    out[2] = rows[2][x];
+                }
+            } else {
+                j.YCbCr_to_RGB_kernel(rgbRow.data(), rows[0], rows[1], rows[2], width, 3);
+                memcpy(out, rgbRow.data(), (size_t)width * 3);
+            }
+        }
+    });
+}
+
+// stbi_load_from_memory(..., 0) 과 같은 결과 (flipVertically 는 stbi_set_flip_vertically_on_load).
+// 결과는 stbi_image_free 로 지운다. 못 풀면 nullptr.
+stbi_uc* decodeJpegParallel(const stbi_uc* buffer, size_t size, int* width, int* height, int* channels,
+                            bool flipVertically) {
+    if (size < 3 || buffer[0] != 0xFF || buffer[1] != 0xD8 || buffer[2] != 0xFF) return nullptr;
+    if (size > (size_t)std::numeric_limits<int>::max()) return nullptr;
+    stbi__context context;
+    stbi__start_mem(&context, buffer, (int)size);
+    context.img_n = 0;
+    std::unique_ptr<stbi__jpeg> j(new stbi__jpeg());
+    j->s = &context;
+    stbi__setup_jpeg(j.get());
+
+    JpegCoefficients coefficients;
+    stbi_uc* output = nullptr;
+    if (decodeJpegCoefficients(*j, coefficients)) {
+        idctJpegComponents(*j);
+        output = (stbi_uc*)stbi__malloc_mad3(context.img_n, (int)context.img_x, (int)context.img_y, 1);
+        if (output) {
+            convertJpegRows(*j, output, flipVertically);
+            *width = (int)context.img_x;
+            *height = (int)context.img_y;
+            *channels = context.img_n;
+        }
+    }
+    stbi__free_jpeg_components(j.get(), context.img_n, 0);
+    return output;
+}
+
+// 이미지 파일 내용을 8 비트 픽셀로 (원래 채널 수, 세로 뒤집음). JPEG 은 decodeJpegParallel, 나머지와
+// 그쪽이 못 푸는 JPEG 은 stb_image. 코어가 하나면 계수 버퍼를 거치는 만큼 느리므로 stb_image 로 바로 간다.
+// 결과는 stbi_image_free 로 지운다.
+stbi_uc* loadImagePixels(const char* data, size_t size, int* width, int* height, int* channels) {
+    stbi_uc* pixels = nullptr;
+    if (std::thread::hardware_concurrency() > 1)
+        pixels = decodeJpegParallel((const stbi_uc*)data, size, width, height, channels, true);
+    if (pixels || size > (size_t)std::numeric_limits<int>::max()) return pixels;
+    stbi_set_flip_vertically_on_load_thread(true);
+    return stbi_load_from_memory((const stbi_uc*)data, (int)size, width, height, channels, 0);
+}
+
+// ===== CPU Mipmaps =====
+// glGenerateMipmap 대신 CPU 에서 2x2 박스 필터로 밉 체인을 만든다 (드라이버마다 다른 필터/감마 처리를
+// 피하고, 작업 스레드에서 미리 해 둔다). 색 채널(3/4 채널 이미지의 RGB)은 sRGB 로 보고 선형 공간에서
+// 평균하고, 알파와 1/2 채널 이미지는 값 그대로 평균한다. 홀수 크기의 마지막 행/열은 버린다
+// (glGenerateMipmap 과 같은 크기 규칙).
+// 0 레벨만 표로 선형값(14비트 정수)으로 풀고, 그 뒤 레벨은 직전 레벨의 선형값에서 바로 만든다
+// (레벨마다 8비트로 다시 양자화하지 않는다). 선형값은 채널 수와 관계없이 픽셀당 4 레인이라
+// SSE2 로 두 픽셀씩 처리하고, 정수 연산이라 스칼라 경로와 결과가 같다.
+const int kLinearSteps = 16383; // 네 값을 더해도 uint16_t 에 들어간다
+
+struct SrgbTables {
+    uint16_t srgbToLinear[256];
+    uint16_t byteToLinear[256];               // 알파/비색 채널
+    unsigned char linearToSrgb[kLinearSteps + 1];
+    unsigned char linearToByte[kLinearSteps + 1];
+
+    SrgbTables() {
+        for (int i = 0; i < 256; ++i) {
+            float c = i / 255.0f;
+            float linear = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            srgbToLinear[i] = (uint16_t)std::lround(linear * kLinearSteps);
+            byteToLinear[i] = (uint16_t)std::lround(c * kLinearSteps);
+        }
+        for (int i = 0; i <= kLinearSteps; ++i) {
+            float linear = (float)i / kLinearSteps;
+            float c = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+            linearToSrgb[i] = (unsigned char)std::lround(std::min(std::max(c, 0.0f), 1.0f) * 255.0f);
+            linearToByte[i] = (unsigned char)std::lround(linear * 255.0f);
+        }
+    }
+};
+
+const SrgbTables& srgbTables() {
+    static const SrgbTables tables;
+    return tables;
+}
+
+// 채널별 8비트 <-> 선형 표
+struct MipChannelTables {
+    const uint16_t* decode[4];
+    const unsigned char* encode[4];
+};
+
+MipChannelTables mipChannelTables(int channels) {
+    const SrgbTables& t = srgbTables();
+    MipChannelTables tables{};
+    for (int c = 0; c < 4; ++c) {
+        bool srgb = channels >= 3 && c < 3;
+        tables.decode[c] = srgb ? t.srgbToLinear : t.byteToLinear;
+        tables.encode[c] = srgb ? t.linearToSrgb : t.linearToByte;
+    }
+    return tables;
+}
+
+// 0 레벨 두 행의 앞 count 픽셀을 선형값으로 풀어 세로로 더한다 (4 레인, 최대 2 x 16383)
+template <int Channels>
+void decodeMipRows(const unsigned char* row0, const unsigned char* row1, const MipChannelTables& tables,
+                   uint16_t* sums, int count) {
+    for (int i = 0; i < count; ++i)
+        for (int c = 0; c < 4; ++c)
+            sums[i * 4 + c] = c < Channels ? tables.decode[c][row0[i * Channels + c]] + tables.decode[c][row1[i * Channels + c]] : 0;
+}
+
+template <int Channels>
+void encodeMipRow(const uint16_t* src, const MipChannelTables& tables, unsigned char* dst, int count) {
+    for (int i = 0; i < count; ++i)
+        for (int c = 0; c < Channels; ++c) dst[i * Channels + c] = tables.encode[c][src[i * 4 + c]];
+}
+
+// 세로로 더해 둔 행에서 가로 두 픽셀씩 더해 평균을 낸다. fromWidth 가 1 이면 같은 열을 두 번 쓴다.
+void downsampleSummedRow(const uint16_t* sums, uint16_t* out, int width, int fromWidth, bool useSimd) {
+    int x = 0;
+#ifdef HAS_SSE2
+    if (useSimd && fromWidth > 1) {
+        const __m128i two = _mm_set1_epi16(2);
+        for (; x + 2 <= width; x += 2) { // 입력 네 픽셀 -> 출력 두 픽셀
+            __m128i lo = _mm_loadu_si128((const __m128i*)(sums + x * 8));
+            __m128i hi = _mm_loadu_si128((const __m128i*)(sums + x * 8 + 8));
+            // 합은 최대 4 x 16383 이라 부호 없는 16비트로 넘치지 않는다
+            __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+            _mm_storeu_si128((__m128i*)(out + x * 4), _mm_srli_epi16(_mm_add_epi16(sum, two), 2));
+        }
+    }
+#endif
+    (void)useSimd;
+    for (; x < width; ++x) {
+        int x0 = 2 * x, x1 = std::min(2 * x + 1, fromWidth - 1);
+        for (int c = 0; c < 4; ++c) out[x * 4 + c] = (uint16_t)((sums[x0 * 4 + c] + sums[x1 * 4 + c] + 2) >> 2);
+    }
+}
+
+// 선형 두 행을 세로로 더한다
+void addLinearRows(const uint16_t* row0, const uint16_t* row1, uint16_t* sums, int count, bool useSimd) {
+    int i = 0;
+#ifdef HAS_SSE2
+    if (useSimd) {
+        for (; i + 8 <= count; i += 8)
+            _mm_storeu_si128((__m128i*)(sums + i), _mm_add_epi16(_mm_loadu_si128((const __m128i*)(row0 + i)),
+                                                                 _mm_loadu_si128((const __m128i*)(row1 + i))));
+    }
+#endif
+    (void)useSimd;
+    for (; i < count; ++i) sums[i] = (uint16_t)(row0[i] + row1[i]);
+}
+
+// 모든 레벨을 한 번에 위에서 아래로 흘려 만든다: 한 레벨의 출력 행이 나오면 바로 다음 레벨의 입력 행이
+// 된다. 레벨마다 출력 행 두 개(짝/홀)만 들고 있어 선형값 전체를 메모리에 두지 않는다.
+template <int Channels>
+struct MipCascade {
+    DecodedImage& image;
+    MipChannelTables tables;
+    bool useSimd;
+    std::vector<uint16_t> sums;                          // 세로 합 (가장 넓은 1 레벨 입력 기준)
+    std::vector<std::vector<uint16_t>> outRows[2];       // 레벨별, 출력 행 번호의 짝/홀
+    std::vector<const uint16_t*> evenRows;               // 레벨별, 짝을 기다리는 윗 레벨 행
+
+    MipCascade(DecodedImage& image, bool useSimd)
+        : image(image), tables(mipChannelTables(Channels)), useSimd(useSimd),
+          sums((size_t)InputWidth(1) * 4), evenRows(image.levels.size(), nullptr) {
+        for (auto& rows : outRows) {
+            rows.resize(image.levels.size());
+            for (size_t i = 1; i < image.levels.size(); ++i) rows[i].resize((size_t)image.levels[i].width * 4);
+        }
+    }
+
+    // level 을 만들 때 읽는 윗 레벨 한 행의 픽셀 수 (홀수 폭의 마지막 열은 읽지 않는다)
+    int InputWidth(size_t level) const {
+        return std::min(image.levels[level - 1].width, 2 * image.levels[level].width);
+    }
+
+    void Run() {
+        const MipLevel& base = image.levels[0];
+        size_t stride = (size_t)base.width * Channels;
+        for (int y = 0; y < image.levels[1].height; ++y) {
+            int y1 = std::min(2 * y + 1, base.height - 1); // 높이가 1 이면 같은 행을 두 번
+            decodeMipRows<Channels>(image.data + 2 * y * stride, image.data + y1 * stride, tables, sums.data(),
+                                    InputWidth(1));
+            Emit(1, y);
+        }
+    }
+
+    // sums 에 세로 합이 준비된 level 의 y 번째 행을 만들어 저장하고 다음 레벨로 넘긴다
+    void Emit(size_t level, int y) {
+        const MipLevel& to = image.levels[level];
+        uint16_t* out = outRows[y % 2][level].data();
+        downsampleSummedRow(sums.data(), out, to.width, InputWidth(level), useSimd);
+        unsigned char* dst = image.mipData.data() + to.offset - image.levels[1].offset;
+        encodeMipRow<Channels>(out, tables, dst + (size_t)y * to.width * Channels, to.width);
+        if (level + 1 < image.levels.size()) Feed(level + 1, y, out);
+    }
+
+    // level - 1 레벨의 row 번째 행 (선형값)
+    void Feed(size_t level, int row, const uint16_t* data) {
+        const MipLevel& from = image.levels[level - 1];
+        int y = row / 2;
+        if (y >= image.levels[level].height) return; // 홀수 높이의 마지막 행
+        const uint16_t* row0 = data;
+        if (from.height > 1) { // 높이가 1 이면 같은 행을 두 번 쓴다
+            if (row % 2 == 0) {
+                evenRows[level] = data; // 윗 레벨이 짝/홀 버퍼를 번갈아 써서 다음 행까지 남아 있다
+                return;
+            }
+            row0 = evenRows[level];
+        }
+        addLinearRows(row0, data, sums.data(), InputWidth(level) * 4, useSimd);
+        Emit(level, y);
+    }
+};
+
+// image.levels / image.mipData 를 채운다. GL 호출 없음.
+void buildMipChain(DecodedImage& image, bool useSimd = true) {
+    image.levels.clear();
+    image.mipData.clear();
+    if (!image.data || image.channels < 1 || image.channels > 4) return;
+
+    size_t offset = 0;
+    int w = image.width, h = image.height;
+    for (;;) {
+        image.levels.push_back({w, h, offset});
+        offset += (size_t)w * h * image.channels;
+        if (w == 1 && h == 1) break;
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    if (image.levels.size() < 2) return;
+    image.mipData.resize(offset - image.levels[1].offset);
+    switch (image.channels) {
+    case 1: MipCascade<1>(image, useSimd).Run(); break;
+    case 2: MipCascade<2>(image, useSimd).Run(); break;
+    case 3: MipCascade<3>(image, useSimd).Run(); break;
+    default: MipCascade<4>(image, useSimd).Run(); break;
+    }
+}
+
+// 레벨 i 의 픽셀 (클라이언트 메모리)
+const unsigned char* mipPixels(const DecodedImage& image, size_t level) {
+    if (level == 0) return image.data;
+    return image.mipData.data() + image.levels[level].offset - image.levels[1].offset;
+}
+
+// ===== Block Compression (BCn) =====
+// --compress-textures: 밉 체인까지 만든 이미지를 4x4 블록 포맷으로 인코딩해 VRAM 과 샘플링 대역폭을 줄인다.
+//   RGB -> BC1 (8 바이트/블록), RGBA -> BC3 (16), R -> BC4 (8), RG -> BC5 (16)
+//   --bc7 이면 RGB/RGBA 를 BC7 모드 6 (16 바이트/블록, RGBA 끝점 + 4비트 인덱스) 으로
+// 색 블록은 주축(PCA)에 투영해 끝점을 잡고, 인덱스를 정한 뒤 최소제곱으로 끝점을 한 번 다시 맞춘다
+// (stb_dxt 와 같은 방식). 투영과 단채널(BC4) 인덱스 선택은 SSE 로 16 픽셀을 한꺼번에 한다.
+// 블록 행 단위로 코어 수만큼 나눠 인코딩한다.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT // EXT_texture_compression_s3tc (glad 에 확장 없이 생성됨)
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+const char* textureCodecName(TextureCodec codec) {
+    switch (codec) {
+    case TextureCodec::BC1: return "BC1";
+    case TextureCodec::BC3: return "BC3";
+    case TextureCodec::BC4: return "BC4";
+    case TextureCodec::BC5: return "BC5";
+    case TextureCodec::BC7: return "BC7";
+    default: return "uncompressed";
+    }
+}
+
+TextureCodec chooseTextureCodec(int channels, TextureCompression compression) {
+    if (compression == TextureCompression::None) return TextureCodec::None;
+    switch (channels) {
+    case 1: return TextureCodec::BC4;
+    case 2: return TextureCodec::BC5;
+    case 3: return compression == TextureCompression::BC7 ? TextureCodec::BC7 : TextureCodec::BC1;
+    default: return compression == TextureCompression::BC7 ? TextureCodec::BC7 : TextureCodec::BC3;
+    }
+}
+
+GLenum textureCodecFormat(TextureCodec codec) {
+    switch (codec) {
+    case TextureCodec::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case TextureCodec::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case TextureCodec::BC4: return GL_COMPRESSED_RED_RGTC1;
+    case TextureCodec::BC5: return GL_COMPRESSED_RG_RGTC2;
+    default: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    }
+}
+
+size_t compressedBlockBytes(TextureCodec codec) {
+    return codec == TextureCodec::BC1 || codec == TextureCodec::BC4 ? 8 : 16;
+}
+
+size_t compressedLevelBytes(TextureCodec codec, int width, int height) {
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * compressedBlockBytes(codec);
+}
+
+// 블록 하나 (가장자리 블록은 마지막 행/열을 되풀이). 채널 순서대로 16 값씩.
+struct BlockPixels {
+    alignas(16) float value[4][16];
+    unsigned char bytes[4][16];
+};
+
+void loadBlock(const unsigned char* pixels, int width, int height, int channels, int bx, int by, BlockPixels& block) {
+    for (int i = 0; i < 16; ++i) {
+        int x = std::min(bx * 4 + (i & 3), width - 1);
+        int y = std::min(by * 4 + (i >> 2), height - 1);
+        const unsigned char* p = pixels + ((size_t)y * width + x) * channels;
+        for (int c = 0; c < 4; ++c) {
+            unsigned char v = c < channels ? p[c] : (c == 3 ? 255 : 0);
+            block.bytes[c][i] = v;
+            block.value[c][i] = v;
+        }
+    }
+}
+
+// t[i] = dot(p_i - origin, direction), 16 픽셀
+void projectBlock(const BlockPixels& block, int channels, const float origin[4], const float direction[4], float t[16]) {
+#ifdef HAS_SSE
+    for (int i = 0; i < 16; i += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for (int c = 0; c < channels; ++c) {
+            __m128 d = _mm_sub_ps(_mm_load_ps(&block.value[c][i]), _mm_set1_ps(origin[c]));
+            sum = _mm_add_ps(sum, _mm_mul_ps(d, _mm_set1_ps(direction[c])));
+        }
+        _mm_storeu_ps(t + i, sum);
+    }
+#else
+    for (int i = 0; i < 16; ++i) {
+        t[i] = 0.0f;
+        for (int c = 0; c < channels; ++c) t[i] += (block.value[c][i] - origin[c]) * direction[c];
+    }
+#endif
+}
+
+// 주축 (공분산 행렬의 최대 고유벡터, 거듭제곱법). 색이 하나뿐이면 false.
+bool principalAxis(const BlockPixels& block, int channels, float mean[4], float axis[4]) {
+    float lo[4], hi[4];
+    for (int c = 0; c < 4; ++c) {
+        mean[c] = 0.0f;
+        axis[c] = 0.0f;
+        lo[c] = 255.0f;
+        hi[c] = 0.0f;
+    }
+    float covariance[4][4] = {};
+#ifdef HAS_SSE
+    // 채널마다 16 값 = 레지스터 네 개
+    __m128 centered[4][4];
+    for (int c = 0; c < channels; ++c) {
+        __m128 v[4], sum, vmin, vmax;
+        for (int k = 0; k < 4; ++k) v[k] = _mm_load_ps(&block.value[c][k * 4]);
+        sum = _mm_add_ps(_mm_add_ps(v[0], v[1]), _mm_add_ps(v[2], v[3]));
+        vmin = _mm_min_ps(_mm_min_ps(v[0], v[1]), _mm_min_ps(v[2], v[3]));
+        vmax = _mm_max_ps(_mm_max_ps(v[0], v[1]), _mm_max_ps(v[2], v[3]));
+        alignas(16) float lanes[3][4];
+        _mm_store_ps(lanes[0], sum);
+        _mm_store_ps(lanes[1], vmin);
+        _mm_store_ps(lanes[2], vmax);
+        mean[c] = (lanes[0][0] + lanes[0][1] + lanes[0][2] + lanes[0][3]) / 16.0f;
+        lo[c] = std::min(std::min(lanes[1][0], lanes[1][1]), std::min(lanes[1][2], lanes[1][3]));
+        hi[c] = std::max(std::max(lanes[2][0], lanes[2][1]), std::max(lanes[2][2], lanes[2][3]));
+        __m128 m = _mm_set1_ps(mean[c]);
+        for (int k = 0; k < 4; ++k) centered[c][k] = _mm_sub_ps(v[k], m);
+    }
+    for (int a = 0; a < channels; ++a)
+        for (int b = a; b < channels; ++b) {
+            __m128 sum = _mm_setzero_ps();
+            for (int k = 0; k < 4; ++k) sum = _mm_add_ps(sum, _mm_mul_ps(centered[a][k], centered[b][k]));
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, sum);
+            covariance[a][b] = covariance[b][a] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        }
+#else
+    for (int c = 0; c < channels; ++c) {
+        for (int i = 0; i < 16; ++i) {
+            mean[c] += block.value[c][i];
+            lo[c] = std::min(lo[c], block.value[c][i]);
+            hi[c] = std::max(hi[c], block.value[c][i]);
+        }
+        mean[c] /= 16.0f;
+    }
+    for (int i = 0; i < 16; ++i)
+        for (int a = 0; a < channels; ++a)
+            for (int b = a; b < channels; ++b)
+                covariance[a][b] += (block.value[a][i] - mean[a]) * (block.value[b][i] - mean[b]);
+    for (int a = 0; a < channels; ++a)
+        for (int b = 0; b < a; ++b) covariance[a][b] = covariance[b][a];
+#endif
+
+    float length = 0.0f;
+    for (int c = 0; c < channels; ++c) {
+        axis[c] = hi[c] - lo[c]; // 시작: 바운딩 박스 대각선
+        length += axis[c] * axis[c];
+    }
+    if (length == 0.0f) return false;
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        float next[4] = {};
+        length = 0.0f;
+        for (int a = 0; a < channels; ++a) {
+            for (int b = 0; b < channels; ++b) next[a] += covariance[a][b] * axis[b];
+            length += next[a] * next[a];
+        }
+        if (length <= 1e-12f) break; // 분산이 거의 없으면 대각선 그대로
+        float scale = 1.0f / std::sqrt(length);
+        for (int c = 0; c < channels; ++c) axis[c] = next[c] * scale;
+    }
+    length = 0.0f;
+    for (int c = 0; c < channels; ++c) length += axis[c] * axis[c];
+    float scale = 1.0f / std::sqrt(length);
+    for (int c = 0; c < channels; ++c) axis[c] *= scale;
+    return true;
+}
+
+// 주축 위 양 끝 픽셀의 투영점 (e0 가 아래쪽)
+void fitEndpoints(const BlockPixels& block, int channels, float e0[4], float e1[4]) {
+    float mean[4], axis[4], t[16];
+    if (!principalAxis(block, channels, mean, axis)) {
+        for (int c = 0; c < 4; ++c) e0[c] = e1[c] = mean[c];
+        return;
+    }
+    projectBlock(block, channels, mean, axis, t);
+    float tMin = t[0], tMax = t[0];
+    for (int i = 1; i < 16; ++i) {
+        tMin = std::min(tMin, t[i]);
+        tMax = std::max(tMax, t[i]);
+    }
+    for (int c = 0; c < 4; ++c) {
+        e0[c] = std::min(std::max(mean[c] + axis[c] * tMin, 0.0f), 255.0f);
+        e1[c] = std::min(std::max(mean[c] + axis[c] * tMax, 0.0f), 255.0f);
+    }
+}
+
+// 픽셀마다 e0 -> e1 사이 위치 (0..1). 끝점이 같으면 모두 0.
+void blockPositions(const BlockPixels& block, int channels, const float e0[4], const float e1[4], float t[16]) {
+    float direction[4] = {}, length = 0.0f;
+    for (int c = 0; c < channels; ++c) {
+        direction[c] = e1[c] - e0[c];
+        length += direction[c] * direction[c];
+    }
+    if (length == 0.0f) {
+        for (int i = 0; i < 16; ++i) t[i] = 0.0f;
+        return;
+    }
+    for (int c = 0; c < channels; ++c) direction[c] /= length;
+    projectBlock(block, channels, e0, direction, t);
+}
+
+// weight[i] 로 섞었을 때 제곱 오차가 최소인 끝점 (2x2 정규방정식). 해가 불안정하면 그대로 둔다.
+void refitEndpoints(const BlockPixels& block, int channels, const float weight[16], float e0[4], float e1[4]) {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f, xa[4] = {}, xb[4] = {};
+    for (int i = 0; i < 16; ++i) {
+        float a = 1.0f - weight[i], b = weight[i];
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = 0; c < channels; ++c) {
+            xa[c] += a * block.value[c][i];
+            xb[c] += b * block.value[c][i];
+        }
+    }
+    float det = aa * bb - ab * ab;
+    if (std::fabs(det) < 1e-6f) return;
+    for (int c = 0; c < channels; ++c) {
+        e0[c] = std::min(std::max((bb * xa[c] - ab * xb[c]) / det, 0.0f), 255.0f);
+        e1[c] = std::min(std::max((aa * xb[c] - ab * xa[c]) / det, 0.0f), 255.0f);
+    }
+}
+
+// [0, maxValue] 로 자른 뒤 반올림 (std::lround 는 블록마다 수십 번 불려 느리다)
+inline int roundClamped(float value, int maxValue) {
+    return (int)(std::min(std::max(value, 0.0f), (float)maxValue) + 0.5f);
+}
+
+float blockError(const BlockPixels& block, int channels, const float palette[][4], const unsigned char index[16]) {
+    float error = 0.0f;
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < channels; ++c) {
+            float d = block.value[c][i] - palette[index[i]][c];
+            error += d * d;
+        }
+    return error;
+}
+
+// --- BC1 (BC3 의 색 블록) ---
+uint16_t packRgb565(const float color[4]) {
+    int r = roundClamped(color[0] * 31.0f / 255.0f, 31);
+    int g = roundClamped(color[1] * 63.0f / 255.0f, 63);
+    int b = roundClamped(color[2] * 31.0f / 255.0f, 31);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+void unpackRgb565(uint16_t packed, float color[4]) {
+    int r = packed >> 11, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = (float)((r << 3) | (r >> 2));
+    color[1] = (float)((g << 2) | (g >> 4));
+    color[2] = (float)((b << 3) | (b >> 2));
+    color[3] = 255.0f;
+}
+
+// 네 색 모드만 쓴다 (color0 > color1). 두 끝점이 같은 565 값이면 인덱스는 모두 0.
+void encodeColorBlock(const BlockPixels& block, unsigned char* out) {
+    float e0[4], e1[4];
+    fitEndpoints(block, 3, e0, e1);
+
+    float bestError = std::numeric_limits<float>::max();
+    uint16_t bestColors[2] = {0, 0};
+    uint32_t bestIndices = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        uint16_t c0 = packRgb565(e1), c1 = packRgb565(e0); // 밝은 쪽이 color0
+        if (c0 < c1) std::swap(c0, c1);
+        float palette[4][4];
+        unpackRgb565(c0, palette[0]);
+        unpackRgb565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+            palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+        }
+        // 직선 위 위치 -> 0, 1/3, 2/3, 1 중 가까운 것
+        static const unsigned char kOrder[4] = {0, 2, 3, 1};
+        float t[16], weight[16];
+        unsigned char index[16];
+        blockPositions(block, 3, palette[0], palette[1], t);
+        uint32_t indices = 0;
+        for (int i = 0; i < 16; ++i) {
+            int step = c0 == c1 ? 0 : roundClamped(t[i] * 3.0f, 3);
+            index[i] = kOrder[step];
+            weight[i] = step / 3.0f;
+            indices |= (uint32_t)index[i] << (2 * i);
+        }
+        float error = blockError(block, 3, palette, index);
+        if (error < bestError) {
+            bestError = error;
+            bestColors[0] = c0;
+            bestColors[1] = c1;
+            bestIndices = indices;
+        }
+        if (pass == 0) { // palette[0] 쪽이 weight 0
+            for (int c = 0; c < 3; ++c) {
+                e0[c] = palette[0][c];
+                e1[c] = palette[1][c];
+            }
+            refitEndpoints(block, 3, weight, e0, e1);
+            std::swap(e0, e1); // 다음 패스의 packRgb565(e1) 가 같은 쪽을 color0 후보로 잡게
+        }
+    }
+    memcpy(out, bestColors, 4);
+    memcpy(out + 4, &bestIndices, 4);
+}
+
+// --- BC4 (BC3 알파, BC5 의 두 채널) ---
+void encodeSingleChannelBlock(const unsigned char values[16], unsigned char* out) {
+    unsigned char lo = values[0], hi = values[0];
+    for (int i = 1; i < 16; ++i) {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+    }
+    // 여덟 값 모드: a0 > a1, 인덱스 0 = a0, 1 = a1, 2..7 = 보간
+    unsigned char palette[8] = {hi, lo};
+    for (int k = 1; k < 7; ++k) palette[k + 1] = (unsigned char)(((7 - k) * hi + k * lo + 3) / 7);
+
+    unsigned char index[16];
+#ifdef HAS_SSE2
+    __m128i v = _mm_loadu_si128((const __m128i*)values);
+    __m128i bestDistance = _mm_set1_epi8((char)0xFF), bestIndex = _mm_setzero_si128();
+    for (int k = 0; k < 8; ++k) {
+        __m128i p = _mm_set1_epi8((char)palette[k]);
+        __m128i distance = _mm_or_si128(_mm_subs_epu8(v, p), _mm_subs_epu8(p, v));
+        __m128i closer = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_min_epu8(distance, bestDistance), bestDistance),
+                                          _mm_set1_epi8(-1)); // distance < bestDistance
+        bestDistance = _mm_min_epu8(distance, bestDistance);
+        bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi8((char)k)), _mm_andnot_si128(closer, bestIndex));
+    }
+    _mm_storeu_si128((__m128i*)index, bestIndex);
+#else
+    for (int i = 0; i < 16; ++i) {
+        int best = 256;
+        for (int k = 0; k < 8; ++k) {
+            int distance = std::abs((int)values[i] - palette[k]);
+            if (distance < best) {
+                best = distance;
+                index[i] = (unsigned char)k;
+            }
+        }
+    }
+#endif
+    uint64_t bits = (uint64_t)hi | ((uint64_t)lo << 8);
+    if (hi == lo) { // 인덱스 모두 0
+        for (int i = 0; i < 16; ++i) index[i] = 0;
+    }
+    for (int i = 0; i < 16; ++i) bits |= (uint64_t)index[i] << (16 + 3 * i);
+    memcpy(out, &bits, 8);
+}
+
+// --- BC7 모드 6 ---
+struct Bc7Writer {
+    uint64_t bits[2] = {0, 0};
+    int position = 0;
+    void Put(uint32_t value, int count) {
+        for (int i = 0; i < count; ++i, ++position)
+            if (value >> i & 1) bits[position >> 6] |= 1ull << (position & 63);
+    }
+};
+
+// 7비트 값 + p 비트. 끝점 하나에 p 비트 하나라 제곱 오차가 작은 쪽을 고른다.
+void quantizeBc7Endpoint(const float color[4], int quantized[4], int& pbit, float dequantized[4]) {
+    float bestError = std::numeric_limits<float>::max();
+    for (int p = 0; p < 2; ++p) {
+        int q[4];
+        float error = 0.0f;
+        for (int c = 0; c < 4; ++c) {
+            q[c] = roundClamped((color[c] - p) / 2.0f, 127);
+            float d = (float)((q[c] << 1) | p) - color[c];
+            error += d * d;
+        }
+        if (error < bestError) {
+            bestError = error;
+            pbit = p;
+            for (int c = 0; c < 4; ++c) {
+                quantized[c] = q[c];
+                dequantized[c] = (float)((q[c] << 1) | p);
+            }
+        }
+    }
+}
+
+void encodeBc7Block(const BlockPixels& block, unsigned char* out) {
+    static const int kWeights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+    float e0[4], e1[4];
+    fitEndpoints(block, 4, e0, e1);
+
+    float bestError = std::numeric_limits<float>::max();
+    int bestQuantized[2][4] = {}, bestPbit[2] = {};
+    unsigned char bestIndex[16] = {};
+    for (int pass = 0; pass < 2; ++pass) {
+        int quantized[2][4], pbit[2];
+        float endpoints[2][4];
+        quantizeBc7Endpoint(e0, quantized[0], pbit[0], endpoints[0]);
+        quantizeBc7Endpoint(e1, quantized[1], pbit[1], endpoints[1]);
+        float palette[16][4];
+        for (int k = 0; k < 16; ++k)
+            for (int c = 0; c < 4; ++c)
+                palette[k][c] = (float)(((64 - kWeights[k]) * (int)endpoints[0][c] + kWeights[k] * (int)endpoints[1][c] + 32) >> 6);
+
+        // 직선 위 위치에서 가장 가까운 가중치 = 그보다 작은 경계(이웃 가중치의 중간) 개수
+        float t[16], weight[16];
+        unsigned char index[16];
+        blockPositions(block, 4, endpoints[0], endpoints[1], t);
+#ifdef HAS_SSE
+        for (int i = 0; i < 16; i += 4) {
+            __m128 position = _mm_loadu_ps(t + i), count = _mm_setzero_ps();
+            for (int k = 0; k < 15; ++k) {
+                __m128 boundary = _mm_set1_ps((kWeights[k] + kWeights[k + 1]) / 128.0f);
+                count = _mm_add_ps(count, _mm_and_ps(_mm_cmpgt_ps(position, boundary), _mm_set1_ps(1.0f)));
+            }
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, count);
+            for (int k = 0; k < 4; ++k) index[i + k] = (unsigned char)lanes[k];
+        }
+#else
+        for (int i = 0; i < 16; ++i) {
+            index[i] = 0;
+            for (int k = 0; k < 15; ++k)
+                if (t[i] > (kWeights[k] + kWeights[k + 1]) / 128.0f) ++index[i];
+        }
+#endif
+        for (int i = 0; i < 16; ++i) weight[i] = kWeights[index[i]] / 64.0f;
+        float error = blockError(block, 4, palette, index);
+        if (error < bestError) {
+            bestError = error;
+            memcpy(bestQuantized, quantized, sizeof(quantized));
+            memcpy(bestPbit, pbit, sizeof(pbit));
+            memcpy(bestIndex, index, sizeof(index));
+        }
+        if (pass == 0) {
+            for (int c = 0; c < 4; ++c) {
+                e0[c] = endpoints[0][c];
+                e1[c] = endpoints[1][c];
+            }
+            refitEndpoints(block, 4, weight, e0, e1);
+        }
+    }
+
+    // 0 번 픽셀 인덱스의 최상위 비트는 0 이어야 한다 (3비트로 저장)
+    if (bestIndex[0] >= 8) {
+        std::swap(bestQuantized[0], bestQuantized[1]);
+        std::swap(bestPbit[0], bestPbit[1]);
+        for (unsigned char& i : bestIndex) i = (unsigned char)(15 - i);
+    }
+    Bc7Writer writer;
+    writer.Put(1 << 6, 7); // 모드 6
+    for (int c = 0; c < 4; ++c) {
+        writer.Put((uint32_t)bestQuantized[0][c], 7);
+        writer.Put((uint32_t)bestQuantized[1][c], 7);
+    }
+    writer.Put((uint32_t)bestPbit[0], 1);
+    writer.Put((uint32_t)bestPbit[1], 1);
+    for (int i = 0; i < 16; ++i) writer.Put(bestIndex[i], i == 0 ? 3 : 4);
+    memcpy(out, writer.bits, 16);
+}
+
+void encodeBlock(TextureCodec codec, const BlockPixels& block, unsigned char* out) {
+    switch (codec) {
+    case TextureCodec::BC1: encodeColorBlock(block, out); break;
+    case TextureCodec::BC3:
+        encodeSingleChannelBlock(block.bytes[3], out);
+        encodeColorBlock(block, out + 8);
+        break;
+    case TextureCodec::BC4: encodeSingleChannelBlock(block.bytes[0], out); break;
+    case TextureCodec::BC5:
+        encodeSingleChannelBlock(block.bytes[0], out);
+        encodeSingleChannelBlock(block.bytes[1], out + 8);
+        break;
+    default: encodeBc7Block(block, out); break;
+    }
+}
+
+// buildMipChain() 을 거친 image 의 모든 레벨을 codec 으로 인코딩해 blocks 에 이어 붙인다.
+// levels 는 blocks 안의 위치로 채운다.
+void compressImage(const DecodedImage& image, TextureCodec codec, std::vector<unsigned char>& blocks,
+                   std::vector<MipLevel>& levels) {
+    levels.clear();
+    size_t total = 0;
+    for (const MipLevel& level : image.levels) {
+        levels.push_back({level.width, level.height, total});
+        total += compressedLevelBytes(codec, level.width, level.height);
+    }
+    blocks.resize(total);
+    size_t blockBytes = compressedBlockBytes(codec);
+    for (size_t i = 0; i < image.levels.size(); ++i) {
+        const MipLevel& level = image.levels[i];
+        const unsigned char* pixels = mipPixels(image, i);
+        int blocksX = (level.width + 3) / 4, blocksY = (level.height + 3) / 4;
+        unsigned char* out = blocks.data() + levels[i].offset;
+        parallelRanges((size_t)blocksY, std::max<size_t>(1, 1024 / blocksX), [&](size_t begin, size_t end) {
+            BlockPixels block;
+            for (size_t by = begin; by < end; ++by)
+                for (int bx = 0; bx < blocksX; ++bx) {
+                    loadBlock(pixels, level.width, level.height, image.channels, bx, (int)by, block);
+                    encodeBlock(codec, block, out + (by * blocksX + bx) * blockBytes);
+                }
+        });
+    }
+}
+
+// ===== Compressed Texture Cache (.texbin) =====
+// 처음 인코딩한 블록(모든 밉 레벨)을 원본 옆에 저장해 두고, 다음 실행부터는 JPEG/PNG 디코딩, 밉 생성,
+// 인코딩을 모두 건너뛰고 블록을 그대로 glCompressedTexSubImage2D 에 넘긴다.
+// 원본 크기와 내용 해시가 같고 코덱이 같을 때만 쓴다.
+const char kTextureCacheMagic[8] = {'T', 'E', 'X', 'B', 'I', 'N', '\0', '\0'};
+const uint32_t kTextureCacheVersion = 1;
+
+struct TextureCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t codec;          // TextureCodec
+    uint64_t sourceSize;
+    uint64_t sourceHash;
+    int32_t width, height;
+    uint32_t channels;
+    uint32_t levelCount;     // 헤더 뒤: 레벨마다 TextureCacheLevel
+    uint64_t dataOffset;
+    uint64_t dataSize;
+};
+
+struct TextureCacheLevel {
+    int32_t width, height;
+    uint64_t offset;         // 블록 데이터 안의 위치
+};
+
+std::string textureCachePath(const std::string& sourcePath) {
+    return sourcePath + ".texbin";
+}
+
+bool writeTextureCache(const std::string& sourcePath, uint64_t sourceSize, uint64_t sourceHash,
+                       const DecodedImage& image) {
+    TextureCacheHeader header{};
+    memcpy(header.magic, kTextureCacheMagic, sizeof(header.magic));
+    header.version = kTextureCacheVersion;
+    header.codec = (uint32_t)image.codec;
+    header.sourceSize = sourceSize;
+    header.sourceHash = sourceHash;
+    header.width = image.width;
+    header.height = image.height;
+    header.channels = (uint32_t)image.channels;
+    header.levelCount = (uint32_t)image.levels.size();
+    header.dataOffset = (sizeof(header) + header.levelCount * sizeof(TextureCacheLevel) + 15) & ~(uint64_t)15;
+    header.dataSize = image.blocks.size();
+
+    // 중간에 실패해도 깨진 캐시가 남지 않도록 임시 파일에 쓰고 교체
+    std::string cachePath = textureCachePath(sourcePath);
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        const char padding[16] = {};
+        out.write((const char*)&header, sizeof(header));
+        for (const MipLevel& level : image.levels) {
+            TextureCacheLevel entry{level.width, level.height, level.offset};
+            out.write((const char*)&entry, sizeof(entry));
+        }
+        out.write(padding, (std::streamsize)(header.dataOffset - sizeof(header) -
+                                             header.levelCount * sizeof(TextureCacheLevel)));
+        out.write((const char*)image.blocks.data(), (std::streamsize)image.blocks.size());
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tempPath);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    std::cout << "Wrote texture cache: " << cachePath << " (" << textureCodecName(image.codec) << ", "
+              << image.blocks.size() / 1024 << " KB)\n";
+    return true;
+}
+
+// 캐시가 없거나 원본/압축 설정과 맞지 않으면 false
+bool readTextureCache(const std::string& sourcePath, uint64_t sourceSize, uint64_t sourceHash,
+                      TextureCompression compression, DecodedImage& image) {
+    MappedFile file;
+    if (!file.Open(textureCachePath(sourcePath)) || file.Size() < sizeof(TextureCacheHeader)) return false;
+    const TextureCacheHeader* header = (const TextureCacheHeader*)file.Data();
+    if (memcmp(header->magic, kTextureCacheMagic, sizeof(header->magic)) != 0 ||
+        header->version != kTextureCacheVersion ||
+        header->sourceSize != sourceSize || header->sourceHash != sourceHash ||
+        header->channels < 1 || header->channels > 4 ||
+        header->codec != (uint32_t)chooseTextureCodec((int)header->channels, compression) ||
+        header->levelCount == 0 || header->levelCount > 32 ||
+        header->dataOffset < sizeof(TextureCacheHeader) + header->levelCount * sizeof(TextureCacheLevel) ||
+        header->dataOffset + header->dataSize > file.Size())
+        return false;
+
+    TextureCodec codec = (TextureCodec)header->codec;
+    const char* cursor = file.Data() + sizeof(TextureCacheHeader);
+    std::vector<MipLevel> levels;
+    for (uint32_t i = 0; i < header->levelCount; ++i) {
+        TextureCacheLevel entry;
+        memcpy(&entry, cursor + i * sizeof(entry), sizeof(entry));
+        if (entry.width < 1 || entry.height < 1 ||
+            entry.offset + compressedLevelBytes(codec, entry.width, entry.height) > header->dataSize)
+            return false;
+        levels.push_back({entry.width, entry.height, (size_t)entry.offset});
+    }
+    image.width = header->width;
+    image.height = header->height;
+    image.channels = (int)header->channels;
+    image.codec = codec;
+    image.levels = std::move(levels);
+    image.blocks.assign(file.Data() + header->dataOffset, file.Data() + header->dataOffset + header->dataSize);
+    return true;
+}
+
+// ===== Texture Upload =====
+// GL 호출이 없으므로 어느 스레드에서나 부를 수 있다. 밉 체인까지 만든다.
+// compression 이 있으면 .texbin 캐시에서 블록을 읽고, 없거나 낡았으면 디코딩 + 인코딩 후 캐시를 쓴다.
+DecodedImage decodeImage(const std::string& filename, TextureCompression compression = TextureCompression::None) {
+    DecodedImage image;
+    MappedFile source;
+    if (!source.Open(filename) || source.Size() == 0 || source.Size() > (size_t)std::numeric_limits<int>::max()) return image;
+    if (compression == TextureCompression::None) {
+        image.data = loadImagePixels(source.Data(), source.Size(), &image.width, &image.height, &image.channels);
+        buildMipChain(image);
+        return image;
+    }
+
+    uint64_t sourceHash = hashBytes(source.Data(), source.Size());
+    if (readTextureCache(filename, source.Size(), sourceHash, compression, image)) return image;
+
+    image.data = loadImagePixels(source.Data(), source.Size(), &image.width, &image.height, &image.channels);
+    if (!image.data) return image;
+    buildMipChain(image);
+    std::vector<unsigned char> blocks;
+    std::vector<MipLevel> levels;
+    TextureCodec codec = chooseTextureCodec(image.channels, compression);
+    compressImage(image, codec, blocks, levels);
+    stbi_image_free(image.data);
+    image.data = nullptr;
+    std::vector<unsigned char>().swap(image.mipData);
+    image.codec = codec;
+    image.blocks = std::move(blocks);
+    image.levels = std::move(levels);
+    if (!writeTextureCache(filename, source.Size(), sourceHash, image))
+        std::cout << "Failed to write texture cache for " << filename << "\n";
+    return image;
+}
+
+// 컨텍스트 스레드에서만. BC4/BC5 (RGTC) 는 3.0 코어, BC1/BC3 은 S3TC 확장, BC7 은 4.2 코어 또는 확장.
+bool textureCodecSupported(TextureCodec codec) {
+    struct Support {
+        bool s3tc = false, bptc = false;
+        Support() {
+            GLint count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+            for (GLint i = 0; i < count; ++i) {
+                const char* name = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+                if (!name) continue;
+                if (strcmp(name, "GL_EXT_texture_compression_s3tc") == 0) s3tc = true;
+                if (strcmp(name, "GL_ARB_texture_compression_bptc") == 0) bptc = true;
+            }
+            if (GLAD_GL_VERSION_4_2) bptc = true;
+        }
+    };
+    static const Support support;
+    switch (codec) {
+    case TextureCodec::BC1:
+    case TextureCodec::BC3: return support.s3tc;
+    case TextureCodec::BC7: return support.bptc;
+    default: return true;
+    }
+}
+
+// image 의 모든 밉 레벨로 텍스처를 만든다. fromPixelBuffer 면 바인딩된 PBO 안의 levels[i].offset 에서,
+// 아니면 image.data / image.mipData (압축이면 image.blocks) 에서 읽는다. 드라이버가 4.2 이상이면
+// glTexStorage2D 로 크기가 고정된 저장소를 잡고 레벨마다 glTex(Compressed)SubImage2D, 아니면 레벨마다
+// glTex(Compressed)Image2D + MAX_LEVEL. 압축 포맷은 textureCodecSupported() 로 미리 확인한다.
+// 만든 텍스처가 GL_TEXTURE_2D 에 바인딩된 채로 돌아온다.
+unsigned int createTexture(const DecodedImage& image, bool fromPixelBuffer) {
+    GLenum format = GL_RGBA, internalFormat = GL_RGBA8;
+    if (image.channels == 1) { format = GL_RED; internalFormat = GL_R8; }
+    else if (image.channels == 2) { format = GL_RG; internalFormat = GL_RG8; }
+    else if (image.channels == 3) { format = GL_RGB; internalFormat = GL_RGB8; }
+    bool compressed = image.codec != TextureCodec::None;
+    if (compressed) internalFormat = textureCodecFormat(image.codec);
+
+    std::vector<MipLevel> baseOnly;
+    const std::vector<MipLevel>* levels = &image.levels;
+    if (levels->empty()) { // buildMipChain() 을 거치지 않은 이미지
+        baseOnly.push_back({image.width, image.height, 0});
+        levels = &baseOnly;
+    }
+    GLsizei levelCount = (GLsizei)levels->size();
+    bool immutable = GLAD_GL_VERSION_4_2 && glTexStorage2D;
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // RGB 이고 폭이 4 의 배수가 아니어도 행 사이 여백 없음
+    if (immutable)
+        glTexStorage2D(GL_TEXTURE_2D, levelCount, internalFormat, image.width, image.height);
+    for (GLsizei i = 0; i < levelCount; ++i) {
+        const MipLevel& level = (*levels)[i];
+        if (compressed) {
+            const void* blocks = fromPixelBuffer ? (const void*)(uintptr_t)level.offset : image.blocks.data() + level.offset;
+            GLsizei size = (GLsizei)compressedLevelBytes(image.codec, level.width, level.height);
+            if (immutable)
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, level.width, level.height, internalFormat, size, blocks);
+            else
+                glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, level.width, level.height, 0, size, blocks);
+            continue;
+        }
+        const void* pixels = fromPixelBuffer ? (const void*)(uintptr_t)level.offset : mipPixels(image, i);
+        if (immutable)
+            glTexSubImage2D(GL_TEXTURE_2D, i, 0, 0, level.width, level.height, format, GL_UNSIGNED_BYTE, pixels);
+        else
+            glTexImage2D(GL_TEXTURE_2D, i, internalFormat, level.width, level.height, 0, format, GL_UNSIGNED_BYTE,
+                         pixels);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (!immutable)
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return textureID;
+}
+
+// 컨텍스트 스레드에서 호출. image.data 는 여기서 해제된다.
+unsigned int uploadTexture(DecodedImage& image, const std::string& filename) {
+    if (imageLoaded(image)) {
+        unsigned int textureID = createTexture(image, false);
+        stbi_image_free(image.data);
+        image.data = nullptr;
+        std::cout << "Loaded texture: " << filename << " (" << image.width << "x" << image.height << ", "
+                  << image.channels << " channels, " << textureCodecName(image.codec) << ")\n";
+        return textureID;
+    }
+    std::cout << "Failed to load texture: " << filename << std::endl;
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    return textureID;
+}
+
+unsigned int loadTexture(const std::string& filename) {
+    DecodedImage image = decodeImage(filename);
+    return uploadTexture(image, filename);
+}
+
+// 작업 스레드 결과를 기다리지 않고 확인만 한다
+template <typename T>
+bool isReady(const std::future<T>& f) {
+    return f.valid() && f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+// ===== Worker Pool =====
+// 고정 개수 스레드 + 작업 큐. std::async 는 요청마다 스레드를 만들어 텍스처 수십 장이면 코어보다
+// 훨씬 많은 디코딩이 동시에 돈다. 렌더 스레드 몫으로 코어 하나를 남긴다.
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t threadCount = 0) {
+        if (threadCount == 0) {
+            unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+            threadCount = cores > 1 ? cores - 1 : 1;
+        }
+        for (size_t i = 0; i < threadCount; ++i)
+            threads.emplace_back([this] { Run(); });
+    }
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool() { Stop(); }
+
+    void Submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        wake.notify_one();
+    }
+
+    // 큐에 남은 작업까지 끝내고 스레드를 모두 멈춘다 (여러 번 불러도 된다)
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+        threads.clear();
+    }
+
+    size_t ThreadCount() const { return threads.size(); }
+
+private:
+    void Run() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> jobs;
+    std::vector<std::thread> threads;
+    bool stopping = false;
+};
+
+// ===== Texture Streaming =====
+// 디코딩과 픽셀 복사는 WorkerPool 에서, GL 호출은 컨텍스트 스레드의 Update() 에서만 한다.
+//   1) 작업 스레드  : decodeImage (디코딩 + 밉 체인)
+//   2) Update()     : 빈 픽셀 버퍼(PBO)를 매핑해 포인터를 넘긴다
+//   3) 작업 스레드  : 매핑된 PBO 로 memcpy
+//   4) Update()     : 언매핑 후 PBO 에서 glTexImage2D (드라이버가 버퍼에서 직접 가져가므로 렌더 스레드는
+//                     복사를 기다리지 않는다), 펜스를 걸고 GPU 가 다 읽으면 PBO 를 다시 쓴다
+// GL 3.3 에는 영구 매핑(glBufferStorage, 4.4)이 없어 매번 glBufferData 로 고아화한 뒤 매핑한다.
+// 프레임마다 새로 매핑하는 바이트를 제한해 큰 텍스처 여러 장이 한 프레임에 몰리지 않게 한다.
+const size_t kTexturePixelBuffers = 4;
+const size_t kTextureUploadBytesPerFrame = 32 << 20; // 넘더라도 프레임마다 최소 한 장은 시작한다
+
+class TextureStreamer {
+public:
+    explicit TextureStreamer(size_t workerCount = 0, TextureCompression compression = TextureCompression::None)
+        : compression(compression), pool(workerCount) {}
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+    ~TextureStreamer() {
+        StopWorkers();
+        for (Entry& r : requests) stbi_image_free(r.image.data);
+        for (Decoded& d : decoded) stbi_image_free(d.image.data);
+    }
+
+    // GL 호출 없음 (컨텍스트 전에 불러도 된다). 렌더 스레드에서만 부른다.
+    size_t Request(const std::string& path) {
+        size_t id = requests.size();
+        requests.emplace_back();
+        requests.back().path = path;
+        Decode(id, compression);
+        return id;
+    }
+
+    // 컨텍스트 스레드에서 프레임마다 호출. GL_PIXEL_UNPACK_BUFFER 와 GL_TEXTURE_2D 바인딩은 0 으로 남긴다.
+    void Update(size_t byteBudget = kTextureUploadBytesPerFrame) {
+        if (buffers.empty()) {
+            buffers.resize(kTexturePixelBuffers);
+            for (PixelBuffer& b : buffers) glGenBuffers(1, &b.buffer);
+        }
+
+        std::vector<Decoded> newlyDecoded;
+        std::vector<size_t> newlyCopied;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            newlyDecoded.swap(decoded);
+            newlyCopied.swap(copied);
+        }
+        for (Decoded& d : newlyDecoded) {
+            Entry& r = requests[d.id];
+            r.image = std::move(d.image);
+            r.decodeSeconds = d.seconds;
+            if (!imageLoaded(r.image)) {
+                r.state = RequestState::Failed;
+                std::cout << "Failed to load texture: " << r.path << std::endl;
+                continue;
+            }
+            // 드라이버가 못 받는 블록 포맷이면 이후 요청까지 압축 없이 다시 디코딩한다
+            if (!textureCodecSupported(r.image.codec)) {
+                std::cout << textureCodecName(r.image.codec) << " textures are not supported by this driver; "
+                          << "decoding " << r.path << " uncompressed\n";
+                compression = TextureCompression::None;
+                r.image = DecodedImage();
+                Decode(d.id, compression);
+                continue;
+            }
+            r.state = RequestState::Decoded;
+            waiting.push_back(d.id);
+        }
+
+        // 4) 복사가 끝난 PBO 에서 텍스처 만들기
+        for (size_t id : newlyCopied) Finish(id);
+
+        // 2) 디코딩 끝난 것을 빈 PBO 에 매핑해 복사를 맡긴다
+        size_t started = 0;
+        while (!waiting.empty()) {
+            Entry& r = requests[waiting.front()];
+            size_t bytes = imageBytes(r.image);
+            if (started > 0 && started + bytes > byteBudget) break;
+            PixelBuffer* buffer = FreeBuffer();
+            if (!buffer) break;
+            size_t id = waiting.front();
+            waiting.pop_front();
+            started += bytes;
+
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->buffer);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)bytes, nullptr, GL_STREAM_DRAW);
+            void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)bytes,
+                                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            if (!mapped) { // 매핑이 안 되면 클라이언트 메모리에서 바로 올린다
+                Upload(r, nullptr);
+                continue;
+            }
+            buffer->inUse = true;
+            r.buffer = buffer;
+            r.state = RequestState::Copying;
+            // 3) 큰 memcpy 는 작업 스레드에서
+            // (vector 를 옮겨도 버퍼 주소는 그대로라 포인터를 들고 가도 된다)
+            bool compressed = r.image.codec != TextureCodec::None;
+            const unsigned char* base = compressed ? r.image.blocks.data() : r.image.data;
+            const unsigned char* mips = r.image.mipData.data();
+            size_t baseBytes = compressed ? bytes : (size_t)r.image.width * r.image.height * r.image.channels;
+            pool.Submit([this, id, mapped, base, mips, baseBytes, bytes] {
+                memcpy(mapped, base, baseBytes);
+                if (bytes > baseBytes) memcpy((unsigned char*)mapped + baseBytes, mips, bytes - baseBytes);
+                std::lock_guard<std::mutex> lock(mutex);
+                copied.push_back(id);
+            });
+        }
+    }
+
+    // 올라갔으면 텍스처 이름, 아니면 0. 텍스처는 호출자 소유 (지울 때 glDeleteTextures).
+    unsigned int Texture(size_t id) const { return id < requests.size() ? requests[id].texture : 0; }
+    bool Failed(size_t id) const { return id < requests.size() && requests[id].state == RequestState::Failed; }
+    // 올라간 텍스처의 밉 포함 바이트 (압축이면 블록 크기), 아직이면 0
+    size_t TextureBytes(size_t id) const { return id < requests.size() ? requests[id].textureBytes : 0; }
+
+    // 남은 작업을 멈추고 GL 자원(PBO, 펜스)을 지운다. 컨텍스트 스레드에서 glfwTerminate 전에.
+    void Release() {
+        StopWorkers();
+        for (size_t id = 0; id < requests.size(); ++id)
+            if (requests[id].state == RequestState::Copying) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, requests[id].buffer->buffer);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        for (PixelBuffer& b : buffers) {
+            if (b.fence) glDeleteSync(b.fence);
+            glDeleteBuffers(1, &b.buffer);
+        }
+        buffers.clear();
+    }
+
+private:
+    enum class RequestState { Decoding, Decoded, Copying, Uploaded, Failed };
+
+    struct PixelBuffer {
+        unsigned int buffer = 0;
+        GLsync fence = nullptr;   // 이 버퍼를 읽는 마지막 업로드 뒤
+        bool inUse = false;       // 매핑되어 복사 중
+    };
+
+    struct Entry {
+        std::string path;
+        RequestState state = RequestState::Decoding;
+        DecodedImage image;
+        double decodeSeconds = 0.0;
+        PixelBuffer* buffer = nullptr;
+        unsigned int texture = 0;
+        size_t textureBytes = 0;
+    };
+
+    struct Decoded {
+        size_t id;
+        DecodedImage image;
+        double seconds;
+    };
+
+    void Decode(size_t id, TextureCompression imageCompression) {
+        std::string path = requests[id].path;
+        pool.Submit([this, id, path, imageCompression] {
+            Decoded result{id, DecodedImage(), 0.0};
+            if (!cancelled) {
+                auto start = std::chrono::steady_clock::now();
+                result.image = decodeImage(path, imageCompression);
+                result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            decoded.push_back(std::move(result));
+        });
+    }
+
+    // 매핑 중이 아니고 GPU 가 이전 업로드를 다 읽은 버퍼
+    PixelBuffer* FreeBuffer() {
+        for (PixelBuffer& b : buffers) {
+            if (b.inUse) continue;
+            if (b.fence) {
+                if (glClientWaitSync(b.fence, 0, 0) == GL_TIMEOUT_EXPIRED) continue;
+                glDeleteSync(b.fence);
+                b.fence = nullptr;
+            }
+            return &b;
+        }
+        return nullptr;
+    }
+
+    void Finish(size_t id) {
+        Entry& r = requests[id];
+        PixelBuffer* buffer = r.buffer;
+        r.buffer = nullptr;
+        buffer->inUse = false;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->buffer);
+        bool intact = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+        if (!intact) { // 매핑 중 버퍼 내용이 사라졌다 (드문 경우): 클라이언트 메모리에서 다시
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            Upload(r, nullptr);
+            return;
+        }
+        Upload(r, buffer);
+    }
+
+    // buffer 가 있으면 그 PBO 에서 (레벨별 offset), 없으면 r.image 의 클라이언트 메모리에서 올린다
+    void Upload(Entry& r, PixelBuffer* buffer) {
+        auto start = std::chrono::steady_clock::now();
+        r.texture = createTexture(r.image, buffer != nullptr);
+        r.textureBytes = imageBytes(r.image);
+        if (buffer) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            buffer->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        double uploadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Loaded texture: " << r.path << " (" << r.image.width << "x" << r.image.height << ", "
+                  << r.image.channels << " channels, " << textureCodecName(r.image.codec) << ", decode "
+                  << r.decodeSeconds * 1000.0 << " ms, "
+                  << (buffer ? "PBO" : "direct") << " upload " << uploadMs << " ms on render thread)\n";
+        stbi_image_free(r.image.data);
+        r.image.data = nullptr;
+        std::vector<unsigned char>().swap(r.image.mipData);
+        std::vector<unsigned char>().swap(r.image.blocks);
+        r.state = RequestState::Uploaded;
+    }
+
+    void StopWorkers() {
+        cancelled = true;
+        pool.Stop();
+        // 멈추기 전에 끝난 결과도 정리 대상에 넣는다
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Decoded& d : decoded) {
+            requests[d.id].image = std::move(d.image);
+            d.image.data = nullptr;
+        }
+        decoded.clear();
+    }
+
+    std::vector<Entry> requests;           // 요청 번호 순, 렌더 스레드만 접근
+    std::deque<size_t> waiting;            // 디코딩 끝, PBO 대기
+    std::vector<PixelBuffer> buffers;      // 크기 고정 (Entry::buffer 가 가리킨다)
+    std::mutex mutex;                      // 아래 두 목록 (작업 스레드 -> 렌더 스레드)
+    std::vector<Decoded> decoded;
+    std::vector<size_t> copied;
+    std::atomic<bool> cancelled{false};
+    TextureCompression compression;        // 새 요청에 쓸 설정 (렌더 스레드만 접근)
+    WorkerPool pool;                       // 마지막 멤버: 먼저 소멸해 작업이 끝난 뒤 나머지가 사라진다
+};
+
+// ===== Texture Manager =====
+// 여러 모델/재질이 같은 이미지를 쓰면 한 번만 디코딩하고 GL 텍스처 하나를 같이 쓴다.
+// 정규화한 경로로 먼저 찾고, 처음 보는 경로면 파일 크기 + 내용 해시로 한 번 더 찾는다 (복사본, 다른 이름).
+// Acquire()/Release() 가 참조 수를 세고 마지막 Release() 에서 텍스처를 지운다.
+// 모두 렌더(컨텍스트) 스레드에서만 부른다.
+struct TextureMemory {
+    size_t textures = 0;     // 살아 있는 텍스처 (올라오는 중 포함)
+    size_t resident = 0;     // GL 에 올라간 것
+    size_t bytes = 0;        // 올라간 텍스처의 밉 포함 바이트 (압축이면 블록 크기)
+    size_t references = 0;   // Acquire 횟수 - Release 횟수
+};
+
+class TextureManager {
+public:
+    static constexpr size_t kNoTexture = (size_t)-1;
+
+    explicit TextureManager(TextureStreamer& streamer) : streamer(streamer) {}
+    TextureManager(const TextureManager&) = delete;
+    TextureManager& operator=(const TextureManager&) = delete;
+
+    // 같은 이미지면 같은 핸들을 돌려주고 참조 수를 올린다
+    size_t Acquire(const std::string& path) {
+        std::error_code ec;
+        std::string canonical = std::filesystem::weakly_canonical(path, ec).string();
+        if (ec) canonical = path;
+        auto byPathIt = byPath.find(canonical);
+        if (byPathIt != byPath.end()) return AddReference(byPathIt->second);
+
+        ContentKey key{0, 0};
+        MappedFile file;
+        bool hashed = file.Open(path);
+        if (hashed) {
+            key = ContentKey{(uint64_t)file.Size(), hashBytes(file.Data(), file.Size())};
+            auto byContentIt = byContent.find(key);
+            if (byContentIt != byContent.end()) {
+                byPath.emplace(canonical, byContentIt->second);
+                entries[byContentIt->second].paths.push_back(canonical);
+                return AddReference(byContentIt->second);
+            }
+        }
+
+        size_t handle = entries.size();
+        entries.emplace_back();
+        Entry& e = entries.back();
+        e.request = streamer.Request(path);
+        e.paths.push_back(canonical);
+        e.hashed = hashed;
+        e.key = key;
+        byPath.emplace(canonical, handle);
+        if (hashed) byContent.emplace(key, handle);
+        return AddReference(handle);
+    }
+
+    // 마지막 참조면 텍스처를 지운다 (아직 안 올라왔으면 올라오는 대로 지운다)
+    void Release(size_t handle) {
+        if (handle >= entries.size() || entries[handle].references == 0) return;
+        Entry& e = entries[handle];
+        if (--e.references > 0) return;
+        for (const std::string& path : e.paths) byPath.erase(path);
+        if (e.hashed) byContent.erase(e.key);
+        e.paths.clear();
+        if (e.texture) glDeleteTextures(1, &e.texture);
+        else if (!streamer.Failed(e.request)) orphans.push_back(e.request);
+        e.texture = 0;
+        e.bytes = 0;
+    }
+
+    // streamer.Update() 뒤에 프레임마다. 새로 올라온 텍스처를 가져온다.
+    void Poll() {
+        size_t pending = 0;
+        for (Entry& e : entries) {
+            if (e.references == 0 || e.texture) continue;
+            e.texture = streamer.Texture(e.request);
+            if (e.texture) e.bytes = streamer.TextureBytes(e.request);
+            else if (!streamer.Failed(e.request)) ++pending;
+        }
+        for (size_t i = 0; i < orphans.size();) {
+            unsigned int texture = streamer.Texture(orphans[i]);
+            if (texture || streamer.Failed(orphans[i])) {
+                if (texture) glDeleteTextures(1, &texture);
+                orphans[i] = orphans.back();
+                orphans.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        if (pending == 0 && wasPending) {
+            TextureMemory memory = Memory();
+            std::cout << "Textures resident: " << memory.resident << " (" << memory.bytes / (1024.0 * 1024.0)
+                      << " MB), " << memory.references << " references\n";
+        }
+        wasPending = pending > 0;
+    }
+
+    // 올라왔으면 텍스처 이름, 아니면 0 (지우지 말 것 - Release 로 돌려준다)
+    unsigned int Texture(size_t handle) const { return handle < entries.size() ? entries[handle].texture : 0; }
+
+    TextureMemory Memory() const {
+        TextureMemory memory;
+        for (const Entry& e : entries) {
+            if (e.references == 0 || (!e.texture && streamer.Failed(e.request))) continue;
+            ++memory.textures;
+            memory.references += e.references;
+            if (e.texture) {
+                ++memory.resident;
+                memory.bytes += e.bytes;
+            }
+        }
+        return memory;
+    }
+
+    // 남은 참조와 관계없이 모두 지운다. 컨텍스트 스레드에서 glfwTerminate 전에.
+    void ReleaseAll() {
+        Poll(); // 마지막 Poll 뒤에 올라온 것도 지운다
+        for (Entry& e : entries) {
+            if (e.texture) glDeleteTextures(1, &e.texture);
+            e = Entry();
+        }
+        byPath.clear();
+        byContent.clear();
+        orphans.clear();
+    }
+
+private:
+    struct ContentKey {
+        uint64_t size, hash;
+        bool operator==(const ContentKey& other) const { return size == other.size && hash == other.hash; }
+    };
+    struct ContentKeyHash {
+        size_t operator()(const ContentKey& key) const { return (size_t)(key.hash ^ (key.size * 0x9E3779B97F4A7C15ull)); }
+    };
+
+    struct Entry {
+        std::vector<std::string> paths; // 이 텍스처로 찾은 정규 경로들
+        size_t request = 0;             // streamer 요청 번호
+        bool hashed = false;            // 파일을 못 열면 경로로만 찾는다
+        ContentKey key{0, 0};
+        unsigned int texture = 0;
+        size_t bytes = 0;
+        size_t references = 0;
+    };
+
+    size_t AddReference(size_t handle) {
+        ++entries[handle].references;
+        return handle;
+    }
+
+    TextureStreamer& streamer;
+    std::vector<Entry> entries;                  // 핸들 = 번호, 다시 쓰지 않는다
+    std::unordered_map<std::string, size_t> byPath;
+    std::unordered_map<ContentKey, size_t, ContentKeyHash> byContent;
+    std::vector<size_t> orphans;                 // 올라오기 전에 버려진 streamer 요청
+    bool wasPending = false;
+};
+
+// ===== Material Textures =====
+// 재질 텍스처를 TextureManager 에서 얻는다 (같은 이미지는 재질/모델 사이에서 공유).
+// 아직 안 올라온 텍스처와 map_Kd 가 없는 재질은 흰색 1x1 텍스처에 Kd 를 곱해 그린다.
+// Bind() 는 텍스처나 색이 실제로 바뀔 때만 GL 상태를 바꾼다.
+class MaterialSet {
+public:
+    MaterialSet(int diffuseColorLocation, TextureManager& textures)
+        : colorLocation(diffuseColorLocation), textures(textures) {}
+    MaterialSet(const MaterialSet&) = delete;
+    MaterialSet& operator=(const MaterialSet&) = delete;
+    ~MaterialSet() { Release(); }
+
+    void Start(const Material* list, size_t count) {
+        materials = list;
+        handles.assign(count, TextureManager::kNoTexture);
+        for (size_t i = 0; i < count; ++i)
+            if (!list[i].diffuseMap.empty()) handles[i] = textures.Acquire(list[i].diffuseMap);
+
+        const unsigned char white[4] = {255, 255, 255, 255};
+        glGenTextures(1, &whiteTexture);
+        glBindTexture(GL_TEXTURE_2D, whiteTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        std::cout << "Materials: " << count << ", " << textures.Memory().textures << " unique textures in use\n";
+    }
+
+    // 다른 코드가 바인딩을 바꿨을 수 있으므로 프레임마다 기억한 상태를 버린다
+    void BeginFrame() {
+        boundTexture = 0;
+        colorValid = false;
+    }
+
+    void Bind(uint32_t material) {
+        unsigned int texture = material < handles.size() ? textures.Texture(handles[material]) : 0;
+        if (!texture) texture = whiteTexture;
+        if (texture != boundTexture) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            boundTexture = texture;
+        }
+        glm::vec3 color = material < handles.size() ? materials[material].diffuse : glm::vec3(1.0f);
+        if (!colorValid || color != boundColor) {
+            glUniform3fv(colorLocation, 1, glm::value_ptr(color));
+            boundColor = color;
+            colorValid = true;
+        }
+    }
+
+    void Release() {
+        for (size_t handle : handles)
+            if (handle != TextureManager::kNoTexture) textures.Release(handle);
+        handles.clear();
+        if (whiteTexture) glDeleteTextures(1, &whiteTexture);
+        whiteTexture = 0;
+    }
+
+private:
+    int colorLocation;
+    const Material* materials = nullptr;
+    TextureManager& textures;
+    std::vector<size_t> handles;                // 재질마다 (kNoTexture 면 텍스처 없음)
+    unsigned int whiteTexture = 0;
+    unsigned int boundTexture = 0;
+    glm::vec3 boundColor{1.0f};
+    bool colorValid = false;
+};
+
+// ===== Mesh Draw =====
+GLenum glIndexType(IndexFormat format) {
+    switch (format) {
+    case IndexFormat::UInt8:  return GL_UNSIGNED_BYTE;
+    case IndexFormat::UInt16: return GL_UNSIGNED_SHORT;
+    default:                  return GL_UNSIGNED_INT;
+    }
+}
+
+// 현재 바인딩된 VAO/VBO 에 정점 포맷에 맞는 속성 포인터를 설정한다
+void setupVertexAttributes(VertexFormat format) {
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    if (format == VertexFormat::Quantized) {
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_FALSE,
+                              sizeof(PackedVertex), (void*)offsetof(PackedVertex, pos));
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_FALSE,
+                              sizeof(PackedVertex), (void*)offsetof(PackedVertex, nor));
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE,
+                              sizeof(PackedVertex), (void*)offsetof(PackedVertex, tex));
+    } else {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
+                              sizeof(Vertex), (void*)offsetof(Vertex, pos));
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE,
+                              sizeof(Vertex), (void*)offsetof(Vertex, nor));
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE,
+                              sizeof(Vertex), (void*)offsetof(Vertex, tex));
+    }
+}
+
+// 모델 바운딩 구가 화면에 투영된 반지름(픽셀)에 LOD 오차(반지름 대비)를 곱해
+// pixelError 이하가 되는 가장 거친 LOD 를 고른다. LOD 가 없으면 0.
+size_t selectLod(const MeshView& mesh, const glm::mat4& world, const glm::vec3& cameraPos,
+                 float fovY, float viewportHeight, float pixelError = 1.0f) {
+    if (mesh.lodCount == 0) return 0;
+    float scale = std::max({glm::length(glm::vec3(world[0])), glm::length(glm::vec3(world[1])),
+                            glm::length(glm::vec3(world[2]))});
+    float radius = mesh.sphereRadius * scale;
+    float distance = glm::length(glm::vec3(world * glm::vec4(mesh.sphereCenter, 1.0f)) - cameraPos);
+    if (distance <= radius) return 0;
+
+    float projectedRadius = radius / (distance * std::tan(fovY * 0.5f)) * viewportHeight * 0.5f;
+    size_t lod = 0;
+    for (size_t i = 1; i < mesh.lodCount; ++i)
+        if (mesh.lods[i].error * projectedRadius <= pixelError) lod = i;
+    return lod;
+}
+
+// [rangeBegin, rangeEnd) 인덱스 구간을 청크마다 한 번씩 그린다. 청크 인덱스는 baseVertex 기준이므로
+// BaseVertex 변형 사용.
+void drawIndexRange(const MeshView& mesh, uint32_t rangeBegin, uint32_t rangeEnd) {
+    GLenum type = glIndexType(mesh.indexFormat);
+    size_t indexSize = indexFormatSize(mesh.indexFormat);
+    for (size_t i = 0; i < mesh.chunkCount; ++i) {
+        const MeshChunk& chunk = mesh.chunks[i];
+        uint32_t begin = std::max(rangeBegin, chunk.indexOffset);
+        uint32_t end = std::min(rangeEnd, chunk.indexOffset + chunk.indexCount);
+        if (begin >= end) continue;
+        const void* offset = (const void*)(begin * indexSize);
+        if (chunk.baseVertex == 0)
+            glDrawElements(GL_TRIANGLES, (GLsizei)(end - begin), type, offset);
+        else
+            glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)(end - begin), type,
+                                     (void*)offset, (GLint)chunk.baseVertex);
+    }
+}
+
+// LOD 가 있으면 해당 LOD 구간만, 재질이 있으면 submesh 마다 재질을 바인딩하고 그린다
+// (submesh 가 텍스처 순이라 바인딩은 텍스처가 바뀔 때만 일어난다).
+void drawMesh(const MeshView& mesh, size_t lod = 0, MaterialSet* materials = nullptr) {
+    uint32_t rangeBegin = 0, rangeEnd = (uint32_t)mesh.indexCount;
+    if (lod < mesh.lodCount) {
+        rangeBegin = mesh.lods[lod].indexOffset;
+        rangeEnd = rangeBegin + mesh.lods[lod].indexCount;
+    }
+    if (!materials || mesh.submeshCount == 0) {
+        drawIndexRange(mesh, rangeBegin, rangeEnd);
+        return;
+    }
+    for (size_t i = 0; i < mesh.submeshCount; ++i) {
+        const Submesh& submesh = mesh.submeshes[i];
+        if (submesh.indexOffset < rangeBegin || submesh.indexOffset >= rangeEnd) continue;
+        materials->Bind(submesh.material);
+        drawIndexRange(mesh, submesh.indexOffset, submesh.indexOffset + submesh.indexCount);
+    }
+}
+
+// 컬링을 통과한 meshlet 만 한 번의 multi-draw 로 그린다
+struct MeshletDrawList {
+    std::vector<uint32_t> visible;
+    std::vector<GLsizei> counts;
+    std::vector<const void*> offsets;
+    std::vector<GLint> baseVertices;
+};
+
+// list.visible 은 meshlets 기준 번호 (cullMeshlets 에 넘긴 것과 같은 배열).
+// 재질이 있으면 submesh 가 바뀔 때마다 모아 둔 것을 그리고 다음 재질을 바인딩한다
+// (meshlet 은 submesh 를 넘지 않고, 둘 다 인덱스 순서라 한 번 훑으면 된다).
+void drawMeshlets(const MeshView& mesh, const Meshlet* meshlets, MeshletDrawList& list,
+                  MaterialSet* materials = nullptr) {
+    size_t indexSize = indexFormatSize(mesh.indexFormat);
+    list.counts.clear();
+    list.offsets.clear();
+    list.baseVertices.clear();
+    auto flush = [&]() {
+        if (list.counts.empty()) return;
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, list.counts.data(), glIndexType(mesh.indexFormat),
+                                      (void* const*)list.offsets.data(), (GLsizei)list.counts.size(),
+                                      list.baseVertices.data());
+        list.counts.clear();
+        list.offsets.clear();
+        list.baseVertices.clear();
+    };
+
+    bool useMaterials = materials && mesh.submeshCount > 0;
+    size_t submesh = 0, boundSubmesh = (size_t)-1;
+    for (uint32_t i : list.visible) {
+        const Meshlet& m = meshlets[i];
+        if (useMaterials) {
+            while (submesh + 1 < mesh.submeshCount &&
+                   m.indexOffset >= mesh.submeshes[submesh].indexOffset + mesh.submeshes[submesh].indexCount)
+                submesh++;
+            if (submesh != boundSubmesh) {
+                flush();
+                materials->Bind(mesh.submeshes[submesh].material);
+                boundSubmesh = submesh;
+            }
+        }
+        list.counts.push_back((GLsizei)m.indexCount);
+        list.offsets.push_back((const void*)(m.indexOffset * indexSize));
+        list.baseVertices.push_back((GLint)m.baseVertex);
+    }
+    flush();
+}
+
+// ===== Model Framing =====
+// 바운딩 구로 모델을 원점에 맞추고 화면에 들어오는 크기로 스케일한 뒤, 그 구가 차지하는
+// 깊이만 near/far 로 잡는다. 모델마다 translate/scale 을 손으로 맞추지 않아도 된다.
+
+// 모델 공간 구 (center, radius) 를 원점 중심, 반지름 fitRadius 로 옮기는 행렬
+glm::mat4 fitToSphere(const glm::vec3& center, float radius, float fitRadius) {
+    float scale = radius > 0.0f ? fitRadius / radius : 1.0f;
+    glm::mat4 m = glm::scale(glm::mat4(1.0f), glm::vec3(scale));
+    return glm::translate(m, -center);
+}
+
+// distance 만큼 떨어진 카메라 (세로 시야각 fovY) 에 구가 꽉 차게 보이는 반지름
+float fitRadiusForView(float distance, float fovY, float margin = 0.9f) {
+    return distance * std::sin(fovY * 0.5f) * margin;
+}
+
+// 월드 공간 구를 앞뒤로 감싸는 near/far. 카메라가 구 안에 있으면 near 는 far 의 1/1000.
+void depthRangeForSphere(const glm::vec3& center, float radius, const glm::vec3& cameraPos,
+                         float& zNear, float& zFar) {
+    float distance = glm::length(center - cameraPos);
+    zFar = distance + radius;
+    zNear = std::max(distance - radius, zFar * 1e-3f);
+}
+
+// ===== Triangle BVH (레이 피킹) =====
+// 삼각형마다 AABB 를 구해 16개 bin 으로 SAH 분할한다. 위쪽 몇 단계만 순차로 나누고
+// 남은 서브트리는 스레드마다 따로 만든 뒤, 깊이 우선 순서의 배열 하나로 이어 붙인다
+// (왼쪽 자식은 항상 바로 다음 노드라 오른쪽 자식 번호만 저장).
+// 리프 삼각형은 리프 순서대로 v0/e1/e2 를 미리 풀어 둬서 질의 중에 인덱스를 따라가지 않는다.
+const int kBvhBins = 16;
+const uint32_t kBvhMaxLeafSize = 8;
+const int kBvhMaxDepth = 64;                 // 순회 스택 크기와 같아야 한다
+const uint32_t kBvhSubtree = 0xFFFFFFFFu;    // 빌드 중에만 쓰는 "병렬 서브트리 자리" 표시
+const size_t kBvhMinTaskTriangles = 4096;
+
+// 32바이트 노드: count 가 0 이면 내부 노드 (leftOrFirst = 오른쪽 자식), 아니면 리프 (첫 삼각형)
+struct BvhNode {
+    float boundsMin[3];
+    uint32_t leftOrFirst;
+    float boundsMax[3];
+    uint32_t count;
+};
+
+struct BvhTriangle {
+    glm::vec3 v0, e1, e2;
+};
+
+struct TriangleBvh {
+    std::vector<BvhNode> nodes;
+    std::vector<BvhTriangle> triangles;  // 리프 순서
+    std::vector<uint32_t> triangleIds;   // 리프 순서 -> 원래 삼각형 번호
+};
+
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 dir;   // 정규화하지 않아도 된다 (t 는 dir 길이 단위)
+    float tMax = std::numeric_limits<float>::infinity();
+};
+
+// 가장 가까운 교차: 위치 = (1 - u - v) * p0 + u * p1 + v * p2
+struct RayHit {
+    float t;
+    float u, v;
+    uint32_t triangle;
+};
+
+struct BvhAabb {
+    glm::vec3 lo{std::numeric_limits<float>::infinity()};
+    glm::vec3 hi{-std::numeric_limits<float>::infinity()};
+
+    void Grow(const glm::vec3& p) { lo = glm::min(lo, p); hi = glm::max(hi, p); }
+    void Grow(const BvhAabb& b) { lo = glm::min(lo, b.lo); hi = glm::max(hi, b.hi); }
+    float HalfArea() const {
+        if (lo.x > hi.x) return 0.0f;
+        glm::vec3 d = hi - lo;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+};
+
+// 병렬로 만들 서브트리 하나: refs[begin, end), 위쪽 트리에서의 깊이
+struct BvhTask {
+    uint32_t begin, end;
+    int depth;
+};
+
+struct BvhBuildState {
+    std::vector<BvhAabb> triBounds;
+    std::vector<glm::vec3> centroids;
+    std::vector<uint32_t> refs;
+};
+
+inline int bvhBin(float c, float lo, float scale) {
+    return std::min(kBvhBins - 1, (int)((c - lo) * scale));
+}
+
+// 최소 SAH 비용의 (축, bin 경계) 를 찾는다. 리프로 두는 편이 싸면 false.
+bool findBvhSplit(const BvhBuildState& state, uint32_t begin, uint32_t end,
+                  const BvhAabb& centroidBounds, float parentArea, int& bestAxis, int& bestBin) {
+    uint32_t count = end - begin;
+    float bestCost = (float)count; // 리프 비용 (삼각형 교차 1회 = 1)
+    bestAxis = -1;
+    for (int axis = 0; axis < 3; ++axis) {
+        float lo = centroidBounds.lo[axis], extent = centroidBounds.hi[axis] - lo;
+        if (extent <= 0.0f) continue;
+        float scale = kBvhBins / extent;
+
+        BvhAabb binBounds[kBvhBins];
+        uint32_t binCount[kBvhBins] = {};
+        for (uint32_t i = begin; i < end; ++i) {
+            uint32_t tri = state.refs[i];
+            int bin = bvhBin(state.centroids[tri][axis], lo, scale);
+            binBounds[bin].Grow(state.triBounds[tri]);
+            binCount[bin]++;
+        }
+
+        // 오른쪽에서 누적한 넓이/개수, 왼쪽은 쓸면서 누적
+        float rightArea[kBvhBins];
+        uint32_t rightCount[kBvhBins];
+        BvhAabb acc;
+        uint32_t n = 0;
+        for (int b = kBvhBins - 1; b > 0; --b) {
+            acc.Grow(binBounds[b]);
+            n += binCount[b];
+            rightArea[b] = acc.HalfArea();
+            rightCount[b] = n;
+        }
+        acc = BvhAabb();
+        n = 0;
+        for (int b = 0; b < kBvhBins - 1; ++b) {
+            acc.Grow(binBounds[b]);
+            n += binCount[b];
+            if (n == 0 || rightCount[b + 1] == 0) continue;
+            float cost = 1.0f + (acc.HalfArea() * n + rightArea[b + 1] * rightCount[b + 1]) / parentArea;
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = b + 1;
+            }
+        }
+    }
+    return bestAxis >= 0;
+}
+
+// [begin, end) 를 nodes 끝에 깊이 우선으로 만든다. tasks 가 있으면 작은 구간은 자리만 남기고
+// 나중에 병렬로 만들도록 tasks 에 넘긴다.
+void buildBvhNode(BvhBuildState& state, std::vector<BvhNode>& nodes, uint32_t begin, uint32_t end,
+                  int depth, std::vector<BvhTask>* tasks, size_t taskSize) {
+    uint32_t index = (uint32_t)nodes.size();
+    nodes.emplace_back();
+
+    BvhAabb bounds, centroidBounds;
+    for (uint32_t i = begin; i < end; ++i) {
+        uint32_t tri = state.refs[i];
+        bounds.Grow(state.triBounds[tri]);
+        centroidBounds.Grow(state.centroids[tri]);
+    }
+    for (int k = 0; k < 3; ++k) {
+        nodes[index].boundsMin[k] = bounds.lo[k];
+        nodes[index].boundsMax[k] = bounds.hi[k];
+    }
+
+    uint32_t count = end - begin;
+    if (tasks && count <= taskSize) {
+        nodes[index].leftOrFirst = (uint32_t)tasks->size();
+        nodes[index].count = kBvhSubtree;
+        tasks->push_back({begin, end, depth});
+        return;
+    }
+
+    int axis = -1, bin = 0;
+    bool split = count > 1 && depth < kBvhMaxDepth - 1 &&
+                 findBvhSplit(state, begin, end, centroidBounds, bounds.HalfArea(), axis, bin);
+    if (!split && (count <= kBvhMaxLeafSize || depth >= kBvhMaxDepth - 1)) {
+        nodes[index].leftOrFirst = begin;
+        nodes[index].count = count;
+        return;
+    }
+
+    uint32_t mid;
+    if (split) {
+        float lo = centroidBounds.lo[axis];
+        float scale = kBvhBins / (centroidBounds.hi[axis] - lo);
+        mid = (uint32_t)(std::partition(state.refs.begin() + begin, state.refs.begin() + end,
+                                        [&](uint32_t tri) {
+                                            return bvhBin(state.centroids[tri][axis], lo, scale) < bin;
+                                        }) - state.refs.begin());
+    } else {
+        // SAH 는 리프가 낫다지만 너무 크다: 가장 긴 축의 중앙값으로 나눈다 (중심이 모두 같아도 반으로)
+        glm::vec3 extent = centroidBounds.hi - centroidBounds.lo;
+        axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        mid = begin + count / 2;
+        std::nth_element(state.refs.begin() + begin, state.refs.begin() + mid, state.refs.begin() + end,
+                         [&](uint32_t a, uint32_t b) { return state.centroids[a][axis] < state.centroids[b][axis]; });
+    }
 
-// ===== Vertex Shader =====
-const char* vertexShaderSource = R"(
-#version 330 core
-precision mediump float;
+    buildBvhNode(state, nodes, begin, mid, depth + 1, tasks, taskSize);
+    nodes[index].leftOrFirst = (uint32_t)nodes.size();
+    nodes[index].count = 0;
+    buildBvhNode(state, nodes, mid, end, depth + 1, tasks, taskSize);
+}
 
-uniform mat4 worldMat, viewMat, projMat;
+// 위쪽 트리를 깊이 우선으로 다시 쓰면서 서브트리 자리에 병렬로 만든 노드를 끼워 넣는다
+void flattenBvh(const std::vector<BvhNode>& top, uint32_t node,
+                const std::vector<std::vector<BvhNode>>& subtrees, std::vector<BvhNode>& out) {
+    const BvhNode& n = top[node];
+    if (n.count == kBvhSubtree) {
+        uint32_t offset = (uint32_t)out.size();
+        for (BvhNode m : subtrees[n.leftOrFirst]) {
+            if (m.count == 0) m.leftOrFirst += offset;
+            out.push_back(m);
+        }
+        return;
+    }
+    uint32_t index = (uint32_t)out.size();
+    out.push_back(n);
+    if (n.count != 0) return;
+    flattenBvh(top, node + 1, subtrees, out);
+    out[index].leftOrFirst = (uint32_t)out.size();
+    flattenBvh(top, n.leftOrFirst, subtrees, out);
+}
 
-layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 normal;
-layout(location = 2) in vec2 texCoord;
+// 삼각형 리스트 (indices 에 3개씩) 로 BVH 를 만든다
+void buildBvh(TriangleBvh& bvh, const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices) {
+    auto startTime = std::chrono::steady_clock::now();
+    size_t triangleCount = indices.size() / 3;
+    bvh = TriangleBvh();
+    if (triangleCount == 0) return;
 
-out vec3 v_normal;
-out vec2 v_texCoord;
+    BvhBuildState state;
+    state.triBounds.resize(triangleCount);
+    state.centroids.resize(triangleCount);
+    state.refs.resize(triangleCount);
+    parallelRanges(triangleCount, 1 << 14, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            BvhAabb box;
+            for (int k = 0; k < 3; ++k) box.Grow(positions[indices[t * 3 + k]]);
+            state.triBounds[t] = box;
+            state.centroids[t] = (box.lo + box.hi) * 0.5f;
+            state.refs[t] = (uint32_t)t;
+        }
+    });
 
-void main() {
-    gl_Position = projMat * viewMat * worldMat * vec4(position, 1.0);
-    v_normal = mat3(transpose(inverse(worldMat))) * normal;
-    v_texCoord = texCoord;
+    // 코어당 서브트리 4개 정도가 되도록 위쪽을 순차로 나눈다
+    size_t workerCount = std::max(1u, std::thread::hardware_concurrency());
+    size_t taskSize = std::max(kBvhMinTaskTriangles, triangleCount / (workerCount * 4));
+    std::vector<BvhNode> top;
+    std::vector<BvhTask> tasks;
+    buildBvhNode(state, top, 0, (uint32_t)triangleCount, 0, &tasks, taskSize);
+
+    // 큰 서브트리부터 가져가도록 순서만 정렬 (tasks 번호는 그대로)
+    std::vector<uint32_t> order(tasks.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return tasks[a].end - tasks[a].begin > tasks[b].end - tasks[b].begin;
+    });
+    std::vector<std::vector<BvhNode>> subtrees(tasks.size());
+    std::atomic<size_t> next{0};
+    runParallel(std::min(workerCount, tasks.size()), [&](size_t) {
+        for (size_t i; (i = next.fetch_add(1)) < order.size();) {
+            const BvhTask& task = tasks[order[i]];
+            buildBvhNode(state, subtrees[order[i]], task.begin, task.end, task.depth, nullptr, 0);
+        }
+    });
+
+    size_t nodeCount = top.size();
+    for (auto& s : subtrees) nodeCount += s.size();
+    bvh.nodes.reserve(nodeCount);
+    flattenBvh(top, 0, subtrees, bvh.nodes);
+
+    bvh.triangles.resize(triangleCount);
+    bvh.triangleIds = std::move(state.refs);
+    parallelRanges(triangleCount, 1 << 14, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t* tri = &indices[bvh.triangleIds[i] * 3];
+            glm::vec3 p0 = positions[tri[0]];
+            bvh.triangles[i] = BvhTriangle{p0, positions[tri[1]] - p0, positions[tri[2]] - p0};
+        }
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "BVH: " << triangleCount << " triangles, " << bvh.nodes.size() << " nodes ("
+              << tasks.size() << " parallel subtrees), " << seconds * 1000.0 << " ms\n";
 }
-)";
 
-// ===== Fragment Shader =====
-const char* fragmentShaderSource = R"(
-#version 330 core
-precision mediump float;
+// 화면에 그리는 메시 (LOD0) 에서 위치와 전역 삼각형 인덱스를 꺼낸다. 캐시에서 읽은 메시도 된다.
+void extractMeshTriangles(const MeshView& mesh, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices) {
+    positions.resize(mesh.vertexCount);
+    if (mesh.vertexFormat == VertexFormat::Quantized) {
+        glm::vec3 center, extent;
+        quantizationFrame(mesh.boundsMin, mesh.boundsMax, center, extent);
+        const PackedVertex* vertices = (const PackedVertex*)mesh.vertices;
+        for (size_t i = 0; i < mesh.vertexCount; ++i)
+            positions[i] = center + glm::vec3(dequantizeSnorm16(vertices[i].pos[0]), dequantizeSnorm16(vertices[i].pos[1]),
+                                              dequantizeSnorm16(vertices[i].pos[2])) * extent;
+    } else {
+        const Vertex* vertices = (const Vertex*)mesh.vertices;
+        for (size_t i = 0; i < mesh.vertexCount; ++i)
+            positions[i] = vertices[i].pos;
+    }
 
-in vec3 v_normal;
-in vec2 v_texCoord;
+    uint32_t rangeEnd = mesh.lodCount > 0 ? mesh.lods[0].indexCount : (uint32_t)mesh.indexCount;
+    indices.clear();
+    indices.reserve(rangeEnd);
+    for (size_t c = 0; c < mesh.chunkCount; ++c) {
+        const MeshChunk& chunk = mesh.chunks[c];
+        uint32_t end = std::min(rangeEnd, chunk.indexOffset + chunk.indexCount);
+        for (uint32_t i = chunk.indexOffset; i < end; ++i) {
+            uint32_t index;
+            switch (mesh.indexFormat) {
+            case IndexFormat::UInt8:  index = ((const uint8_t*)mesh.indices)[i]; break;
+            case IndexFormat::UInt16: index = ((const uint16_t*)mesh.indices)[i]; break;
+            default:                  index = ((const uint32_t*)mesh.indices)[i]; break;
+            }
+            indices.push_back(index + chunk.baseVertex);
+        }
+    }
+}
 
-uniform sampler2D textureSampler;
+void buildBvh(TriangleBvh& bvh, const MeshView& mesh) {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    extractMeshTriangles(mesh, positions, indices);
+    buildBvh(bvh, positions, indices);
+}
 
-layout(location = 0) out vec4 fragColor;
+// 슬랩 테스트. 맞으면 진입 거리, 아니면 무한대.
+inline float intersectBvhNode(const BvhNode& n, const glm::vec3& origin, const glm::vec3& invDir, float tMax) {
+    float tx1 = (n.boundsMin[0] - origin.x) * invDir.x, tx2 = (n.boundsMax[0] - origin.x) * invDir.x;
+    float ty1 = (n.boundsMin[1] - origin.y) * invDir.y, ty2 = (n.boundsMax[1] - origin.y) * invDir.y;
+    float tz1 = (n.boundsMin[2] - origin.z) * invDir.z, tz2 = (n.boundsMax[2] - origin.z) * invDir.z;
+    float tNear = std::max({std::min(tx1, tx2), std::min(ty1, ty2), std::min(tz1, tz2), 0.0f});
+    float tFar = std::min({std::max(tx1, tx2), std::max(ty1, ty2), std::max(tz1, tz2), tMax});
+    return tNear <= tFar ? tNear : std::numeric_limits<float>::infinity();
+}
 
-void main() {
-    fragColor = texture(textureSampler, v_texCoord);
+// Möller–Trumbore. 양면 모두 맞는 것으로 친다.
+inline bool intersectBvhTriangle(const BvhTriangle& tri, const Ray& ray, float tMax, float& t, float& u, float& v) {
+    glm::vec3 p = glm::cross(ray.dir, tri.e2);
+    float det = glm::dot(tri.e1, p);
+    if (std::fabs(det) < 1e-12f) return false;
+    float invDet = 1.0f / det;
+    glm::vec3 s = ray.origin - tri.v0;
+    u = glm::dot(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f) return false;
+    glm::vec3 q = glm::cross(s, tri.e1);
+    v = glm::dot(ray.dir, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f) return false;
+    t = glm::dot(tri.e2, q) * invDet;
+    return t > 0.0f && t < tMax;
 }
-)";
 
-// ===== Camera Class =====
-class Camera {
-public:
-    glm::vec3 position;
-    float yaw;
-    float pitch;
-    float sensitivity;
+inline glm::vec3 safeInverse(const glm::vec3& d) {
+    const float kTiny = 1e-30f;
+    return glm::vec3(1.0f / (std::fabs(d.x) > kTiny ? d.x : std::copysign(kTiny, d.x)),
+                     1.0f / (std::fabs(d.y) > kTiny ? d.y : std::copysign(kTiny, d.y)),
+                     1.0f / (std::fabs(d.z) > kTiny ? d.z : std::copysign(kTiny, d.z)));
+}
 
-    Camera() : position(0.0f, 0.0f, 5.0f), yaw(-90.0f), pitch(0.0f), sensitivity(0.1f) {}
+// anyHit 이면 처음 맞는 삼각형에서 바로 끝낸다 (hit 는 그 삼각형)
+bool traverseBvh(const TriangleBvh& bvh, const Ray& ray, RayHit& hit, bool anyHit) {
+    const float kInf = std::numeric_limits<float>::infinity();
+    if (bvh.nodes.empty()) return false;
+    glm::vec3 invDir = safeInverse(ray.dir);
+    float tMax = ray.tMax;
+    bool found = false;
 
-    glm::mat4 GetViewMatrix() {
-        glm::vec3 front;
-        front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
-        front.y = sin(glm::radians(pitch));
-        front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
-        glm::vec3 cameraFront = glm::normalize(front);
-        return glm::lookAt(position, position + cameraFront, glm::vec3(0.0f, 1.0f, 0.0f));
+    struct Entry { uint32_t node; float t; };
+    Entry stack[kBvhMaxDepth];
+    int sp = 0;
+    float t0 = intersectBvhNode(bvh.nodes[0], ray.origin, invDir, tMax);
+    if (t0 == kInf) return false;
+    stack[sp++] = {0, t0};
+
+    while (sp > 0) {
+        Entry e = stack[--sp];
+        if (e.t >= tMax) continue; // 더 가까운 교차가 이미 있다
+        uint32_t node = e.node;
+        for (;;) {
+            const BvhNode& n = bvh.nodes[node];
+            if (n.count != 0) {
+                for (uint32_t i = n.leftOrFirst; i < n.leftOrFirst + n.count; ++i) {
+                    float t, u, v;
+                    if (!intersectBvhTriangle(bvh.triangles[i], ray, tMax, t, u, v)) continue;
+                    tMax = t;
+                    hit = RayHit{t, u, v, bvh.triangleIds[i]};
+                    found = true;
+                    if (anyHit) return true;
+                }
+                break;
+            }
+            uint32_t a = node + 1, b = n.leftOrFirst;
+            float ta = intersectBvhNode(bvh.nodes[a], ray.origin, invDir, tMax);
+            float tb = intersectBvhNode(bvh.nodes[b], ray.origin, invDir, tMax);
+            if (ta > tb) {
+                std::swap(a, b);
+                std::swap(ta, tb);
+            }
+            if (ta == kInf) break;
+            if (tb != kInf) stack[sp++] = {b, tb};
+            node = a;
+        }
     }
+    return found;
+}
 
-    void ProcessMouseMovement(float xoffset, float yoffset) {
-        xoffset *= sensitivity;
-        yoffset *= sensitivity;
+bool intersectClosest(const TriangleBvh& bvh, const Ray& ray, RayHit& hit) {
+    return traverseBvh(bvh, ray, hit, false);
+}
 
-        yaw += xoffset;
-        pitch += yoffset;
+bool intersectAny(const TriangleBvh& bvh, const Ray& ray) {
+    RayHit hit;
+    return traverseBvh(bvh, ray, hit, true);
+}
 
-        if (pitch > 89.0f) pitch = 89.0f;
-        if (pitch < -89.0f) pitch = -89.0f;
+// 바운딩 구 바깥 (반지름 2배) 에서 구 안쪽 임의의 점으로 쏘는 레이로 단일 스레드 처리량을 잰다
+void benchmarkBvh(const TriangleBvh& bvh, const glm::vec3& center, float radius, size_t rayCount = 1 << 20) {
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    auto randomInBall = [&]() {
+        glm::vec3 p;
+        do p = glm::vec3(unit(rng), unit(rng), unit(rng));
+        while (glm::dot(p, p) > 1.0f);
+        return p;
+    };
+    std::vector<Ray> rays(rayCount);
+    for (Ray& ray : rays) {
+        glm::vec3 from = center + glm::normalize(randomInBall() + glm::vec3(1e-6f)) * radius * 2.0f;
+        glm::vec3 to = center + randomInBall() * radius;
+        ray.origin = from;
+        ray.dir = to - from;
     }
-};
 
-// Global camera instance
-Camera camera;
+    for (int mode = 0; mode < 2; ++mode) {
+        size_t hits = 0;
+        auto startTime = std::chrono::steady_clock::now();
+        for (const Ray& ray : rays) {
+            RayHit hit;
+            hits += mode == 0 ? intersectClosest(bvh, ray, hit) : intersectAny(bvh, ray);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << (mode == 0 ? "  Closest hit: " : "  Any hit    : ")
+                  << rayCount / seconds / 1e6 << " Mrays/s, " << seconds * 1e6 / rayCount << " us/ray, "
+                  << hits << "/" << rayCount << " hit\n";
+    }
+}
 
-// Mouse state
-float lastX = 400.0f, lastY = 300.0f;
-bool firstMouse = true;
+// ===== Background Asset Loading =====
+// OBJ 파싱/메시 가공과 이미지 디코딩은 작업 스레드에서 하고, 메인 루프는 그동안 빈 화면을
+// 그리며 이벤트를 계속 처리한다. 결과가 준비되면 컨텍스트 스레드에서 GL 업로드만 한다.
+struct MeshLoadOptions {
+    VertexFormat vertexFormat = VertexFormat::Float;
+    bool tangents = false;
+    bool clusterCulling = false;
+    bool lods = false;
+    bool strict16 = false;   // 65536 정점을 넘어도 16비트 인덱스 (청크로 나눈다)
+};
 
-// Mouse callback
-void mouse_callback(GLFWwindow*, double xpos, double ypos) {
-    float xposf = static_cast<float>(xpos);
-    float yposf = static_cast<float>(ypos);
+// view 는 cache 또는 objData 를 가리키므로 한 덩어리로 힙에 두고 옮기지 않는다
+struct LoadedMesh {
+    MeshCache cache;
+    ObjData objData;
+    MeshView view;
+    TriangleBvh bvh;
+};
 
-    if (firstMouse) {
-        lastX = xposf;
-        lastY = yposf;
-        firstMouse = false;
+// GL 호출 없음. 실패하면 nullptr.
+std::unique_ptr<LoadedMesh> loadMesh(const std::string& objFilePath, const MeshLoadOptions& options) {
+    auto mesh = std::make_unique<LoadedMesh>();
+    // .meshbin 캐시가 유효하면 OBJ 파싱을 건너뛰고 매핑된 배열을 그대로 업로드
+    if (openMeshCache(objFilePath, mesh->cache, options.vertexFormat, options.tangents,
+                      options.clusterCulling, options.lods, options.strict16)) {
+        mesh->view = mesh->cache.view;
+    } else {
+        ObjData& objData = mesh->objData;
+        if (!loadOBJ(objFilePath, objData))
+            return nullptr;
+        if (options.tangents)
+            generateTangents(objData);
+        if (options.lods)
+            buildLods(objData);
+        optimizeVertexCache(objData);
+        optimizeOverdraw(objData);
+        packIndices(objData, options.strict16);
+        if (options.clusterCulling)
+            buildMeshlets(objData);
+        if (options.vertexFormat == VertexFormat::Quantized)
+            quantizeVertices(objData);
+        if (!writeMeshCache(objFilePath, objData))
+            std::cout << "Could not write mesh cache for " << objFilePath << "\n";
+        mesh->view = makeMeshView(objData);
     }
 
-    float xoffset = xposf - lastX;
-    float yoffset = lastY - yposf; // reversed since y-coordinates range from bottom to top
-    lastX = xposf;
-    lastY = yposf;
-
-    camera.ProcessMouseMovement(xoffset, yoffset);
+    // 마우스 피킹용 BVH (화면에 그리는 LOD0 기준)
+    buildBvh(mesh->bvh, mesh->view);
+    return mesh;
 }
 
-// ===== Vertex/ObjData =====
-struct Vertex {
-    glm::vec3 pos;
-    glm::vec3 nor;
-    glm::vec2 tex;
+struct MeshBuffers {
+    unsigned int vao = 0, vbo = 0, ebo = 0, tangentVbo = 0;
 };
 
-struct ObjData {
+void uploadMesh(const MeshView& mesh, MeshBuffers& buffers) {
+    glGenVertexArrays(1, &buffers.vao);
+    glGenBuffers(1, &buffers.vbo);
+    glGenBuffers(1, &buffers.ebo);
+
+    glBindVertexArray(buffers.vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.vbo);
+    glBufferData(GL_ARRAY_BUFFER,
+                 (GLsizeiptr)(mesh.vertexCount * vertexFormatSize(mesh.vertexFormat)),
+                 mesh.vertices,
+                 GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 (GLsizeiptr)(mesh.indexCount * indexFormatSize(mesh.indexFormat)),
+                 mesh.indices,
+                 GL_STATIC_DRAW);
+
+    setupVertexAttributes(mesh.vertexFormat);
+
+    // 탄젠트는 정점 포맷과 무관한 별도 스트림 (없으면 셰이더에는 기본값 (0,0,0,1))
+    if (mesh.tangents) {
+        glGenBuffers(1, &buffers.tangentVbo);
+        glBindBuffer(GL_ARRAY_BUFFER, buffers.tangentVbo);
+        glBufferData(GL_ARRAY_BUFFER,
+                     (GLsizeiptr)(mesh.vertexCount * sizeof(glm::vec4)),
+                     mesh.tangents,
+                     GL_STATIC_DRAW);
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+    }
+}
+
+void deleteMesh(MeshBuffers& buffers) {
+    if (buffers.vao) glDeleteVertexArrays(1, &buffers.vao);
+    if (buffers.vbo) glDeleteBuffers(1, &buffers.vbo);
+    if (buffers.ebo) glDeleteBuffers(1, &buffers.ebo);
+    if (buffers.tangentVbo) glDeleteBuffers(1, &buffers.tangentVbo);
+    buffers = MeshBuffers();
+}
+
+// ===== Streaming OBJ Upload =====
+// 파일을 고정 크기 창 단위로 파싱하면서 창마다 해석된 삼각형을 배치로 넘기고, 렌더 스레드는
+// 받은 배치를 GPU 버퍼 뒤에 붙여 지금까지 올라간 인덱스 앞부분만 그린다. 전체 정점 배열이
+// CPU 에 한꺼번에 있을 일이 없는 대신, 최적화 패스/LOD/meshlet/BVH/캐시는 쓰지 않는다.
+// (정점 재사용은 배치 안에서만, vn 이 없으면 면 법선)
+const size_t kStreamWindowBytes = 4 << 20;
+const size_t kStreamMaxQueuedBatches = 8;   // 렌더 스레드가 밀리면 파서가 기다린다
+const size_t kStreamBatchesPerFrame = 4;
+
+struct MeshBatch {
     std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
+    std::vector<unsigned int> indices;  // 전역 정점 번호 (앞 배치들의 정점 수 기준)
+    // 지금까지 읽은 v 레코드 전체의 bounds
+    glm::vec3 boundsMin, boundsMax;
+    glm::vec3 sphereCenter;
+    float sphereRadius;
 };
 
-// ===== OBJ Loader (v/vt/vn, v//vn, v 지원) =====
-bool loadOBJ(const std::string& filename, ObjData& objData) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+// 파서 스레드 하나 -> 렌더 스레드 하나
+class MeshBatchQueue {
+public:
+    // 큐가 차 있으면 기다린다. 소비자가 Cancel() 했으면 false.
+    bool Push(MeshBatch&& batch) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&] { return batches.size() < kStreamMaxQueuedBatches || cancelled; });
+        if (cancelled) return false;
+        batches.push_back(std::move(batch));
+        return true;
+    }
+
+    bool TryPop(MeshBatch& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (batches.empty()) return false;
+        batch = std::move(batches.front());
+        batches.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void Cancel() {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+        batches.clear();
+        notFull.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::deque<MeshBatch> batches;
+    bool cancelled = false;
+};
+
+// GL 호출 없음. 삼각형을 하나라도 보냈으면 true.
+bool streamOBJ(const std::string& filename, MeshBatchQueue& queue) {
+    auto startTime = std::chrono::steady_clock::now();
+    MappedFile file;
+    if (!file.Open(filename)) {
         std::cerr << "Failed to open OBJ file: " << filename << std::endl;
         return false;
     }
+    if (objCompression(file.Data(), file.Size()) != ObjCompression::None) {
+        std::cerr << "--stream needs an uncompressed OBJ: " << filename << std::endl;
+        return false;
+    }
 
-    std::vector<glm::vec3> temp_positions;
-    std::vector<glm::vec3> temp_normals;
-    std::vector<glm::vec2> temp_texcoords;
-
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        std::istringstream iss(line);
-        std::string prefix;
-        iss >> prefix;
+    std::vector<glm::vec3> positions, normals;
+    std::vector<glm::vec2> texcoords;
+    BoundsAccumulator bounds;
+    glm::vec3 sphereCenter(0.0f);
+    float sphereRadius = -1.0f; // 음수면 아직 위치가 없음
+    Arena windowArena;  // 창마다 비운다
+    size_t vertexBase = 0, triangleCount = 0, batchCount = 0;
 
-        if (prefix == "v") {
-            glm::vec3 p;
-            iss >> p.x >> p.y >> p.z;
-            temp_positions.push_back(p);
+    const char* p = file.Data();
+    const char* end = p + file.Size();
+    while (p < end) {
+        const char* windowEnd = p + std::min(kStreamWindowBytes, (size_t)(end - p));
+        if (windowEnd < end) {
+            const char* nl = (const char*)memchr(windowEnd, '\n', (size_t)(end - windowEnd));
+            windowEnd = nl ? nl + 1 : end;
         }
-        else if (prefix == "vn") {
-            glm::vec3 n;
-            iss >> n.x >> n.y >> n.z;
-            temp_normals.push_back(n);
+        std::vector<ObjChunk> window(1);
+        ObjChunk& chunk = window[0];
+        countOBJChunk(p, windowEnd, chunk);
+        windowArena.Reset();
+        allocateOBJChunks(window, windowArena);
+        parseOBJChunk(p, windowEnd, chunk);
+        p = windowEnd;
+
+        positions.insert(positions.end(), chunk.positions, chunk.positions + chunk.positionCount);
+        normals.insert(normals.end(), chunk.normals, chunk.normals + chunk.normalCount);
+        texcoords.insert(texcoords.end(), chunk.texcoords, chunk.texcoords + chunk.texcoordCount);
+        bounds.Merge(chunk.bounds);
+        if (!bounds.Empty()) {
+            // 구 중심은 지금까지의 AABB 중심. 이번 창의 위치만 정확히 재고, 이전 위치는 옛 구를
+            // 중심이 움직인 만큼 키워 덮는다. AABB 를 감싸는 구보다 커지지 않게 자른다.
+            glm::vec3 center = bounds.Center();
+            float radius = maxDistance(chunk.positions, chunk.positionCount, center);
+            if (sphereRadius >= 0.0f)
+                radius = std::max(radius, sphereRadius + glm::length(center - sphereCenter));
+            sphereCenter = center;
+            sphereRadius = std::min(radius, bounds.HalfDiagonal() * (1.0f + 1e-6f));
         }
-        else if (prefix == "vt") {
-            glm::vec2 t;
-            iss >> t.x >> t.y;
-            temp_texcoords.push_back(t);
-        }
-        else if (prefix == "f") {
-            std::string v1, v2, v3;
-            iss >> v1 >> v2 >> v3;
-
-            auto parseVertex = [&](const std::string& s) {
-                unsigned int pi = 0, ti = 0, ni = 0;
-                size_t p1 = s.find('/');
-                if (p1 == std::string::npos) {
-                    pi = std::stoul(s) - 1;
-                } else {
-                    pi = std::stoul(s.substr(0, p1)) - 1;
-                    size_t p2 = s.find('/', p1 + 1);
-                    if (p2 == std::string::npos) {
-                        ti = std::stoul(s.substr(p1 + 1)) - 1;
-                    } else {
-                        if (p2 > p1 + 1)
-                            ti = std::stoul(s.substr(p1 + 1, p2 - p1 - 1)) - 1;
-                        if (p2 + 1 < s.size())
-                            ni = std::stoul(s.substr(p2 + 1)) - 1;
+        if (chunk.cornerCount == 0) continue;
+
+        MeshBatch batch;
+        batch.indices.reserve(chunk.cornerCount);
+        VertexWeldTable vertexCache(windowArena, chunk.cornerCount / 4);
+        for (size_t c = 0; c + 2 < chunk.cornerCount; c += 3) {
+            const VertexKey* tri = &chunk.corners[c];
+            if (tri[0].pi >= positions.size() || tri[1].pi >= positions.size() || tri[2].pi >= positions.size())
+                continue; // 아직 안 나온 (또는 잘못된) 위치를 가리키는 면
+            glm::vec3 faceNormal = glm::cross(positions[tri[1].pi] - positions[tri[0].pi],
+                                              positions[tri[2].pi] - positions[tri[0].pi]);
+            float len = glm::length(faceNormal);
+            faceNormal = len > 0.0f ? faceNormal / len : glm::vec3(0.0f, 1.0f, 0.0f);
+            for (int k = 0; k < 3; ++k) {
+                const VertexKey& key = tri[k];
+                if (!normals.empty()) {
+                    bool inserted;
+                    unsigned int local = vertexCache.Insert(key, (unsigned int)batch.vertices.size(), inserted);
+                    if (!inserted) {
+                        batch.indices.push_back((unsigned int)vertexBase + local);
+                        continue;
                     }
                 }
-
                 Vertex v{};
-                v.pos = temp_positions[pi];
-                if (!temp_normals.empty() && ni < temp_normals.size())
-                    v.nor = temp_normals[ni];
-                else
-                    v.nor = glm::vec3(0.0f, 1.0f, 0.0f);
+                v.pos = positions[key.pi];
+                v.nor = key.ni < normals.size() ? normals[key.ni] : faceNormal;
+                v.tex = key.ti < texcoords.size() ? texcoords[key.ti] : glm::vec2(0.0f);
+                batch.indices.push_back((unsigned int)(vertexBase + batch.vertices.size()));
+                batch.vertices.push_back(v);
+            }
+        }
+        if (batch.indices.empty()) continue;
 
-                if (!temp_texcoords.empty() && ti < temp_texcoords.size())
-                    v.tex = temp_texcoords[ti];
-                else
-                    v.tex = glm::vec2(0.0f, 0.0f);
+        batch.boundsMin = bounds.Min();
+        batch.boundsMax = bounds.Max();
+        batch.sphereCenter = sphereCenter;
+        batch.sphereRadius = sphereRadius;
+        vertexBase += batch.vertices.size();
+        triangleCount += batch.indices.size() / 3;
+        batchCount++;
+        if (!queue.Push(std::move(batch)))
+            return false;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Streamed OBJ file: " << filename << "\n";
+    std::cout << "  Vertices : " << vertexBase << "\n";
+    std::cout << "  Triangles: " << triangleCount << " in " << batchCount << " batches\n";
+    std::cout << "  Parsed   : " << file.Size() / (1024.0 * 1024.0) << " MB in " << seconds * 1000.0 << " ms\n";
+    return triangleCount > 0;
+}
 
-                objData.vertices.push_back(v);
-                return (unsigned int)(objData.vertices.size() - 1);
-            };
+// 렌더 스레드 쪽: 배치를 받을 때마다 뒤에 붙이고, 모자라면 두 배 크기 버퍼로 옮긴다
+struct StreamingMesh {
+    MeshBuffers buffers;
+    size_t vertexCapacity = 0, indexCapacity = 0; // 바이트
+    size_t vertexCount = 0, indexCount = 0;
+    MeshChunk chunk{0, 0, 0, 0};
+};
 
-            objData.indices.push_back(parseVertex(v1));
-            objData.indices.push_back(parseVertex(v2));
-            objData.indices.push_back(parseVertex(v3));
+// 새 버퍼를 만들어 기존 내용을 GPU 에서 복사한다. 호출 뒤 buffer 는 새 이름.
+void growBuffer(unsigned int& buffer, size_t usedBytes, size_t& capacity, size_t neededBytes) {
+    size_t newCapacity = std::max<size_t>(capacity, 1 << 20);
+    while (newCapacity < neededBytes) newCapacity *= 2;
+    unsigned int grown;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)newCapacity, nullptr, GL_STATIC_DRAW);
+    if (buffer) {
+        if (usedBytes) {
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)usedBytes);
         }
+        glDeleteBuffers(1, &buffer);
     }
+    buffer = grown;
+    capacity = newCapacity;
+}
 
-    file.close();
+void appendMeshBatch(StreamingMesh& mesh, const MeshBatch& batch) {
+    if (!mesh.buffers.vao) glGenVertexArrays(1, &mesh.buffers.vao);
+    glBindVertexArray(mesh.buffers.vao);
 
-    std::cout << "Loaded OBJ file: " << filename << "\n";
-    std::cout << "  Vertices : " << objData.vertices.size() << "\n";
-    std::cout << "  Indices  : " << objData.indices.size()  << "\n";
-    std::cout << "  Triangles: " << objData.indices.size() / 3 << "\n";
+    size_t vertexBytes = mesh.vertexCount * sizeof(Vertex);
+    size_t addVertexBytes = batch.vertices.size() * sizeof(Vertex);
+    if (vertexBytes + addVertexBytes > mesh.vertexCapacity) {
+        growBuffer(mesh.buffers.vbo, vertexBytes, mesh.vertexCapacity, vertexBytes + addVertexBytes);
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.buffers.vbo);
+        setupVertexAttributes(VertexFormat::Float);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.buffers.vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)vertexBytes, (GLsizeiptr)addVertexBytes, batch.vertices.data());
 
-    return !objData.vertices.empty() && !objData.indices.empty();
+    size_t indexBytes = mesh.indexCount * sizeof(unsigned int);
+    size_t addIndexBytes = batch.indices.size() * sizeof(unsigned int);
+    if (indexBytes + addIndexBytes > mesh.indexCapacity) {
+        growBuffer(mesh.buffers.ebo, indexBytes, mesh.indexCapacity, indexBytes + addIndexBytes);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.buffers.ebo);
+    }
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)indexBytes, (GLsizeiptr)addIndexBytes, batch.indices.data());
+
+    mesh.vertexCount += batch.vertices.size();
+    mesh.indexCount += batch.indices.size();
+    mesh.chunk = MeshChunk{0, (uint32_t)mesh.indexCount, 0, (uint32_t)mesh.vertexCount};
 }
 
-// ===== Texture Loader =====
-unsigned int loadTexture(const std::string& filename) {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
+// drawMesh() 로 그릴 수 있도록 지금까지 올라간 부분을 MeshView 로
+MeshView makeMeshView(const StreamingMesh& mesh, const MeshBatch& last) {
+    MeshView view;
+    view.vertexCount = mesh.vertexCount;
+    view.boundsMin = last.boundsMin;
+    view.boundsMax = last.boundsMax;
+    view.sphereCenter = last.sphereCenter;
+    view.sphereRadius = last.sphereRadius;
+    view.indexCount = mesh.indexCount;
+    view.indexFormat = IndexFormat::UInt32;
+    view.chunks = &mesh.chunk;
+    view.chunkCount = 1;
+    return view;
+}
 
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrChannels, 0);
-
-    if (data) {
-        GLenum format = GL_RGB;
-        if (nrChannels == 1)
-            format = GL_RED;
-        else if (nrChannels == 3)
-            format = GL_RGB;
-        else if (nrChannels == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-        std::cout << "Loaded texture: " << filename << " (" << width << "x" << height << ", " << nrChannels << " channels)\n";
-    } else {
-        std::cout << "Failed to load texture: " << filename << std::endl;
-        stbi_image_free(data);
+// ===== Loader Benchmark (--bench-load) =====
+// 결정적인 합성 OBJ(잔물결 격자 + 고정 시드 잡음)를 만들어 loadOBJ 를 단계별로 잰다. GL 없이 돈다.
+// 파일은 bench_obj/ 에 한 번 만들어 두고 재사용한다.
+
+// 프로세스 최대 상주 메모리. 프로세스 전체의 최대값이라 --bench-load 는 입력마다 새 프로세스에서 부른다.
+size_t peakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss;
+#else
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+enum class SyntheticLayout { Position, PositionNormal, Full };
+
+const char* syntheticLayoutName(SyntheticLayout layout) {
+    switch (layout) {
+    case SyntheticLayout::Position:       return "v";
+    case SyntheticLayout::PositionNormal: return "v//vn";
+    default:                              return "v/vt/vn";
     }
+}
 
-    return textureID;
+// quadsX x quadsY 격자를 삼각형 정확히 triangleCount 개만큼 쓴다. 같은 인자면 같은 바이트.
+bool writeSyntheticOBJ(const std::string& path, size_t triangleCount, SyntheticLayout layout) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    size_t quadsX = std::max<size_t>(1, (size_t)std::sqrt(triangleCount / 2.0));
+    size_t quadsY = std::max<size_t>(1, (triangleCount / 2 + quadsX) / quadsX);
+    bool normals = layout != SyntheticLayout::Position;
+    bool texcoords = layout == SyntheticLayout::Full;
+    std::mt19937 rng(20240901u); // 분포 클래스는 구현마다 결과가 달라 비트를 직접 쓴다
+
+    std::string out;
+    out.reserve(kObjWindowBytes + 4096);
+    bool ok = true;
+    auto flush = [&](bool force) {
+        if (!force && out.size() < kObjWindowBytes) return;
+        ok = ok && fwrite(out.data(), 1, out.size(), file) == out.size();
+        out.clear();
+    };
+
+    char line[128];
+    out += "# synthetic grid for --bench-load\n";
+    for (size_t y = 0; y <= quadsY; ++y) {
+        for (size_t x = 0; x <= quadsX; ++x) {
+            float u = (float)x / quadsX, v = (float)y / quadsY;
+            float jitter = ((rng() >> 8) * (1.0f / 16777216.0f) - 0.5f) * 0.002f;
+            float height = 0.05f * std::sin(u * 25.1327f) * std::cos(v * 25.1327f) + jitter;
+            out.append(line, (size_t)snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", u, height, v));
+            if (normals) {
+                glm::vec3 n = glm::normalize(glm::vec3(-1.2566f * std::cos(u * 25.1327f) * std::cos(v * 25.1327f), 1.0f,
+                                                       1.2566f * std::sin(u * 25.1327f) * std::sin(v * 25.1327f)));
+                out.append(line, (size_t)snprintf(line, sizeof(line), "vn %.4f %.4f %.4f\n", n.x, n.y, n.z));
+            }
+            if (texcoords)
+                out.append(line, (size_t)snprintf(line, sizeof(line), "vt %.6f %.6f\n", u, v));
+            flush(false);
+        }
+    }
+
+    // 모든 속성이 위치와 같은 번호라 코너 토큰은 "i", "i//i", "i/i/i"
+    auto corner = [&](size_t index) {
+        char number[24];
+        char* end = std::to_chars(number, number + sizeof(number), index).ptr;
+        out += ' ';
+        out.append(number, end);
+        if (layout == SyntheticLayout::PositionNormal) {
+            out += "//";
+            out.append(number, end);
+        } else if (layout == SyntheticLayout::Full) {
+            out += '/';
+            out.append(number, end);
+            out += '/';
+            out.append(number, end);
+        }
+    };
+    size_t written = 0;
+    for (size_t y = 0; y < quadsY && written < triangleCount; ++y) {
+        for (size_t x = 0; x < quadsX && written < triangleCount; ++x) {
+            size_t a = y * (quadsX + 1) + x + 1, b = a + 1, c = a + quadsX + 1, d = c + 1;
+            out += 'f'; corner(a); corner(b); corner(d); out += '\n';
+            if (++written < triangleCount) {
+                out += 'f'; corner(a); corner(d); corner(c); out += '\n';
+                ++written;
+            }
+            flush(false);
+        }
+    }
+    flush(true);
+    ok = fclose(file) == 0 && ok;
+    return ok;
+}
+
+// 각 단계 로그를 잠시 끈다 (표만 보이게)
+struct ScopedSilence {
+    std::streambuf* saved = std::cout.rdbuf(nullptr);
+    ~ScopedSilence() {
+        std::cout.rdbuf(saved);
+        std::cout.clear();
+    }
+};
+
+// 10K ~ maxTriangles (최대 50M) 삼각형, 세 가지 면 형식마다:
+//   I/O     : 매핑한 파일의 모든 페이지를 한 번 읽는 시간 (이후 단계는 페이지 캐시가 찬 상태)
+//   count/parse/resolve/finish : loadOBJ 단계 (ObjLoadStats)
+//   prep    : 업로드 준비 (정점 캐시/오버드로 최적화 + 인덱스 패킹 + MeshView)
+//   peak RSS: 입력마다 자기 실행 파일을 --bench-case 로 다시 띄워 그 프로세스의 최대 상주 메모리를 잰다.
+//             띄우지 못하면 이 프로세스에서 재고 "-" 로 표시한다.
+//   overdraw: optimizeOverdraw 전 -> 후 analyzeOverdraw (prep 시간에서 뺀다). 래스터화가 비싸서
+//             kBenchOverdrawMaxTriangles 이하에서만 잰다.
+const size_t kBenchOverdrawMaxTriangles = 1000000;
+
+// 표 한 줄. ownProcess 면 이 입력만 읽은 프로세스라 peakResidentBytes 가 이 입력의 값이다.
+bool runLoaderBenchmarkCase(const std::string& path, size_t triangles, SyntheticLayout layout, bool ownProcess) {
+    auto ioStart = std::chrono::steady_clock::now();
+    volatile uint64_t touched = 0; // 읽기가 최적화로 사라지지 않게
+    {
+        MappedFile file;
+        if (!file.Open(path)) {
+            std::cerr << "Failed to open " << path << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < file.Size(); i += 4096) touched = touched + (unsigned char)file.Data()[i];
+    }
+    double ioSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - ioStart).count();
+
+    uint64_t allocationsBefore = allocationCount.load();
+    ObjLoadStats stats;
+    ObjData objData;
+    double loadSeconds, prepSeconds, analyzeSeconds = 0.0;
+    uint64_t analyzeAllocations = 0;
+    bool measureOverdraw = triangles <= kBenchOverdrawMaxTriangles;
+    OverdrawStats overdrawBefore{0, 0, 0.0f}, overdrawAfter{0, 0, 0.0f};
+    bool loaded;
+    {
+        ScopedSilence silence;
+        auto loadStart = std::chrono::steady_clock::now();
+        loaded = loadOBJ(path, objData, true, 0, &stats);
+        auto prepStart = std::chrono::steady_clock::now();
+        if (loaded) {
+            optimizeVertexCache(objData);
+            if (measureOverdraw) {
+                auto analyzeStart = std::chrono::steady_clock::now();
+                uint64_t analyzeAllocationsBefore = allocationCount.load();
+                overdrawBefore = analyzeOverdraw(objData);
+                analyzeAllocations = allocationCount.load() - analyzeAllocationsBefore;
+                analyzeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - analyzeStart).count();
+            }
+            optimizeOverdraw(objData);
+            packIndices(objData);
+            MeshView view = makeMeshView(objData);
+            (void)view;
+        }
+        auto prepEnd = std::chrono::steady_clock::now();
+        loadSeconds = std::chrono::duration<double>(prepStart - loadStart).count();
+        prepSeconds = std::chrono::duration<double>(prepEnd - prepStart).count() - analyzeSeconds;
+    }
+    uint64_t allocations = allocationCount.load() - allocationsBefore - analyzeAllocations;
+    if (loaded && measureOverdraw) overdrawAfter = analyzeOverdraw(objData);
+    if (!loaded) {
+        std::cerr << "Failed to load " << path << std::endl;
+        return false;
+    }
+
+    double megabytes = stats.textBytes / (1024.0 * 1024.0);
+    double totalSeconds = loadSeconds + prepSeconds;
+    char overdraw[32] = "-";
+    if (measureOverdraw)
+        snprintf(overdraw, sizeof(overdraw), "%.3f -> %.3f", overdrawBefore.overdraw, overdrawAfter.overdraw);
+    char allocs[24] = "-"; // 할당 카운터는 LOADER_BENCH 빌드에만 있다
+#ifdef LOADER_BENCH
+    snprintf(allocs, sizeof(allocs), "%llu", (unsigned long long)allocations);
+#else
+    (void)allocations;
+#endif
+    char peak[24] = "-";
+    if (ownProcess) snprintf(peak, sizeof(peak), "%.1f", peakResidentBytes() / (1024.0 * 1024.0));
+    char row[256];
+    snprintf(row, sizeof(row),
+             "%9zu  %-7s %9.1f %9.2f %9.2f %9.2f %11.2f %10.2f %8.2f %10.2f %8.1f %8.2f %12s %10s  %12s\n",
+             triangles, syntheticLayoutName(layout), megabytes, ioSeconds * 1000.0,
+             stats.countSeconds * 1000.0, stats.parseSeconds * 1000.0, stats.resolveSeconds * 1000.0,
+             stats.finishSeconds * 1000.0, prepSeconds * 1000.0, totalSeconds * 1000.0,
+             loadSeconds > 0.0 ? megabytes / loadSeconds : 0.0,
+             totalSeconds > 0.0 ? objData.indices.size() / 3 / totalSeconds / 1e6 : 0.0,
+             peak, allocs, overdraw);
+    std::cout << row << std::flush;
+    return true;
+}
+
+int runLoaderBenchmark(const std::string& executable, size_t maxTriangles) {
+    const std::string directory = "bench_obj";
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    std::cout << "Loader benchmark (" << std::max(1u, std::thread::hardware_concurrency()) << " threads)\n";
+    std::cout << "triangles  layout       MB    I/O ms  count ms  parse ms  resolve ms  finish ms  prep ms"
+                 "   total ms     MB/s   Mtri/s  peak RSS MB     allocs      overdraw\n";
+    const size_t sizes[] = {10000, 100000, 1000000, 10000000, 50000000};
+    const SyntheticLayout layouts[] = {SyntheticLayout::Position, SyntheticLayout::PositionNormal,
+                                       SyntheticLayout::Full};
+    bool spawnCases = !executable.empty(); // 한 번 실패하면 나머지도 이 프로세스에서
+    for (size_t triangles : sizes) {
+        if (triangles > maxTriangles) break;
+        for (SyntheticLayout layout : layouts) {
+            std::string tag = layout == SyntheticLayout::Position ? "v" :
+                              layout == SyntheticLayout::PositionNormal ? "vn" : "vtn";
+            std::string path = directory + "/synthetic_" + std::to_string(triangles) + "_" + tag + ".obj";
+            if (!std::filesystem::exists(path, ec)) {
+                std::cout << "  generating " << path << "\n";
+                if (!writeSyntheticOBJ(path, triangles, layout)) {
+                    std::cerr << "Failed to write " << path << std::endl;
+                    return -1;
+                }
+            }
+
+            std::string command = "\"" + executable + "\" --bench-case " + path + " " +
+                                  std::to_string(triangles) + " " + std::to_string((int)layout);
+#ifdef _WIN32
+            command = "\"" + command + "\""; // cmd /c 가 바깥 따옴표 한 쌍을 벗긴다
+#endif
+            std::cout << std::flush;
+            if (spawnCases && std::system(command.c_str()) == 0) continue;
+            spawnCases = false;
+            if (!runLoaderBenchmarkCase(path, triangles, layout, false))
+                return -1;
+        }
+    }
+    return 0;
 }
 
 // ===== Shader / Program =====
@@ -276,9 +6451,143 @@ unsigned int createProgram(unsigned int vs, unsigned int fs) {
     return prog;
 }
 
+// ===== Mip Benchmark (--bench-mips) =====
+// 결정적인 합성 이미지(그라디언트 + 고정 시드 잡음)로 buildMipChain 을 잰다. GL 없이 돈다.
+// SSE/스칼라 경로를 한 스레드에서 비교하고, 코어 수만큼 이미지를 동시에 돌린 처리량도 본다
+// (TextureStreamer 가 작업 스레드마다 한 장씩 디코딩 + 밉 생성을 하는 상황).
+std::vector<unsigned char> syntheticImage(int width, int height, int channels) {
+    std::vector<unsigned char> pixels((size_t)width * height * channels);
+    uint32_t seed = 0x9E3779B9u ^ (uint32_t)(width * 31 + channels);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned char* p = &pixels[((size_t)y * width + x) * channels];
+            for (int c = 0; c < channels; ++c) {
+                seed = seed * 1664525u + 1013904223u;
+                int gradient = c == 0 ? x * 255 / width : c == 1 ? y * 255 / height : (x + y) * 255 / (width + height);
+                p[c] = (unsigned char)std::min(255, std::max(0, gradient + (int)(seed >> 28) - 8));
+            }
+        }
+    }
+    return pixels;
+}
+
+int runMipBenchmark() {
+    size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Mip chain benchmark (" << threadCount << " threads, 2x2 box filter, sRGB-correct color)\n";
+    std::cout << "     size  ch  levels   scalar ms     SIMD ms  SIMD Mpix/s  SIMD MB/s  speedup   parallel MB/s\n";
+    const int sizes[] = {512, 1024, 2048, 4096};
+    const int channelCounts[] = {3, 4};
+    for (int size : sizes) {
+        for (int channels : channelCounts) {
+            std::vector<unsigned char> pixels = syntheticImage(size, size, channels);
+            DecodedImage image;
+            image.data = pixels.data();
+            image.width = image.height = size;
+            image.channels = channels;
+
+            // 작은 이미지는 여러 번 돌려 평균한다
+            int repeats = std::max(1, (4096 / size) * (4096 / size) / 4);
+            double seconds[2];
+            for (int simd = 0; simd < 2; ++simd) {
+                auto start = std::chrono::steady_clock::now();
+                for (int r = 0; r < repeats; ++r) buildMipChain(image, simd == 1);
+                seconds[simd] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repeats;
+            }
+            double basePixels = (double)size * size;
+            double baseMegabytes = basePixels * channels / (1024.0 * 1024.0);
+
+            // 스레드마다 자기 이미지 하나씩 (공유 입력, 출력은 각자)
+            auto parallelStart = std::chrono::steady_clock::now();
+            runParallel(threadCount, [&](size_t) {
+                DecodedImage copy;
+                copy.data = pixels.data();
+                copy.width = copy.height = size;
+                copy.channels = channels;
+                for (int r = 0; r < repeats; ++r) buildMipChain(copy);
+                copy.data = nullptr;
+            });
+            double parallelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - parallelStart).count();
+
+            char row[256];
+            snprintf(row, sizeof(row), "%9d  %2d  %6zu  %10.2f  %10.2f  %11.1f  %9.1f  %6.2fx  %14.1f\n",
+                     size, channels, image.levels.size(), seconds[0] * 1000.0, seconds[1] * 1000.0,
+                     seconds[1] > 0.0 ? basePixels / seconds[1] / 1e6 : 0.0,
+                     seconds[1] > 0.0 ? baseMegabytes / seconds[1] : 0.0,
+                     seconds[1] > 0.0 ? seconds[0] / seconds[1] : 0.0,
+                     parallelSeconds > 0.0 ? baseMegabytes * repeats * threadCount / parallelSeconds : 0.0);
+            std::cout << row << std::flush;
+            image.data = nullptr; // pixels 소유
+        }
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     std::string objFilePath = "models/cat.obj";
-    if (argc > 1) objFilePath = argv[1];
+    bool useQuantizedVertices = false;
+    bool useTangents = false;
+    bool useClusterCulling = false;
+    bool useLods = false;
+    bool useStrict16 = false;
+    bool benchmarkRays = false;
+    bool streamMesh = false;
+#ifdef LOADER_BENCH
+    bool benchmarkLoader = true; // build_bench.bat: 창 없이 벤치마크만
+#else
+    bool benchmarkLoader = false;
+#endif
+    size_t benchmarkTriangles = 1000000; // --bench-load [최대 삼각형 수], 최대 50M
+    bool benchmarkMips = false;
+    TextureCompression textureCompression = TextureCompression::None; // --compress-textures, --bc7
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        // --bench-load 가 입력마다 띄우는 자식 프로세스: --bench-case <경로> <삼각형 수> <면 형식>
+        if (arg == "--bench-case" && i + 3 < argc)
+            return runLoaderBenchmarkCase(argv[i + 1], std::stoull(argv[i + 2]),
+                                          (SyntheticLayout)std::atoi(argv[i + 3]), true) ? 0 : 1;
+        if (arg == "--quantize") useQuantizedVertices = true;
+        else if (arg == "--tangents") useTangents = true;
+        else if (arg == "--cull-clusters") useClusterCulling = true;
+        else if (arg == "--lod") useLods = true;
+        else if (arg == "--strict16") useStrict16 = true;
+        else if (arg == "--bench-rays") benchmarkRays = true;
+        else if (arg == "--stream") streamMesh = true;
+        else if (arg == "--bench-load") benchmarkLoader = true;
+        else if (arg == "--bench-mips") benchmarkMips = true;
+        else if (arg == "--compress-textures") textureCompression = TextureCompression::BCn;
+        else if (arg == "--bc7") textureCompression = TextureCompression::BC7;
+        else if (benchmarkLoader && !arg.empty() && isdigit((unsigned char)arg[0])) benchmarkTriangles = std::stoull(arg);
+        else objFilePath = arg;
+    }
+    // 창/GL 컨텍스트 없이 로더만 잰다
+    if (benchmarkLoader)
+        return runLoaderBenchmark(argc > 0 ? argv[0] : "", benchmarkTriangles);
+    if (benchmarkMips)
+        return runMipBenchmark();
+    if (streamMesh && (useQuantizedVertices || useTangents || useClusterCulling || useLods || useStrict16 || benchmarkRays)) {
+        std::cout << "--stream uploads raw parser output; ignoring mesh processing options\n";
+        useQuantizedVertices = useTangents = useClusterCulling = useLods = useStrict16 = benchmarkRays = false;
+    }
+    VertexFormat vertexFormat = useQuantizedVertices ? VertexFormat::Quantized : VertexFormat::Float;
+
+    // 창을 만드는 동안 이미 메시 파싱과 텍스처 디코딩이 돌도록 가장 먼저 띄운다
+    MeshLoadOptions loadOptions;
+    loadOptions.vertexFormat = vertexFormat;
+    loadOptions.tangents = useTangents;
+    loadOptions.clusterCulling = useClusterCulling;
+    loadOptions.lods = useLods;
+    loadOptions.strict16 = useStrict16;
+    const std::string texturePath = "textures/cat.jpg";
+    MeshBatchQueue meshBatches;
+    std::future<std::unique_ptr<LoadedMesh>> meshJob;
+    std::future<bool> streamJob;
+    if (streamMesh)
+        streamJob = std::async(std::launch::async, streamOBJ, objFilePath, std::ref(meshBatches));
+    else
+        meshJob = std::async(std::launch::async, loadMesh, objFilePath, loadOptions);
+    TextureStreamer textureStreamer(0, textureCompression);
+    TextureManager textureManager(textureStreamer);
+    size_t textureHandle = textureManager.Acquire(texturePath);
 
     if (!glfwInit()) {
         std::cout << "Failed to initialize GLFW\n";
@@ -300,6 +6609,7 @@ int main(int argc, char* argv[]) {
 
     // Setup mouse input
     glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
@@ -309,56 +6619,14 @@ int main(int argc, char* argv[]) {
 
     glEnable(GL_DEPTH_TEST);
 
-    unsigned int vs = compileShader(GL_VERTEX_SHADER,   vertexShaderSource);
+    unsigned int vs = compileShader(GL_VERTEX_SHADER,
+                                    useQuantizedVertices ? quantizedVertexShaderSource : vertexShaderSource);
     unsigned int fs = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSource);
     unsigned int program = createProgram(vs, fs);
     glDeleteShader(vs);
     glDeleteShader(fs);
     glUseProgram(program);
 
-    ObjData objData;
-    if (!loadOBJ(objFilePath, objData)) {
-        std::cout << "OBJ load failed. Check models/cat.obj\n";
-        glfwTerminate();
-        return -1;
-    }
-
-    // Load texture
-    unsigned int texture = loadTexture("textures/cat.jpg");
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture);
-
-    unsigned int VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER,
-                 (GLsizeiptr)(objData.vertices.size() * sizeof(Vertex)),
-                 objData.vertices.data(),
-                 GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                 (GLsizeiptr)(objData.indices.size() * sizeof(unsigned int)),
-                 objData.indices.data(),
-                 GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex), (void*)offsetof(Vertex, pos));
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex), (void*)offsetof(Vertex, nor));
-
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE,
-                          sizeof(Vertex), (void*)offsetof(Vertex, tex));
-
     int worldMatLoc = glGetUniformLocation(program, "worldMat");
     int viewMatLoc  = glGetUniformLocation(program, "viewMat");
     int projMatLoc  = glGetUniformLocation(program, "projMat");
@@ -366,11 +6634,28 @@ int main(int argc, char* argv[]) {
 
     // Bind texture to texture unit 0
     glUniform1i(textureLoc, 0);
+    glUniform3f(glGetUniformLocation(program, "diffuseColor"), 1.0f, 1.0f, 1.0f);
+
+    std::unique_ptr<LoadedMesh> loadedMesh;
+    MeshView mesh;
+    MeshBuffers meshBuffers;
+    StreamingMesh streamingMesh;
+    unsigned int texture = 0;
+    MaterialSet materials(glGetUniformLocation(program, "diffuseColor"), textureManager);
+    bool loadFailed = false;
 
     glm::mat4 worldMatrix, viewMatrix, projMatrix;
+    MeshletDrawList meshletDraws;
+    size_t currentLod = 0;
+
+    // 어떤 모델이든 원점 중심, 카메라 시야의 90% 크기로
+    const float fovY = glm::radians(45.0f);
+    float fitRadius = fitRadiusForView(glm::length(camera.position), fovY);
+    glm::mat4 fitMatrix(1.0f);
 
     std::cout << "\n=== Controls ===\n";
     std::cout << "Mouse: Look around\n";
+    std::cout << "Left click: pick surface point at screen center\n";
     std::cout << "ESC: exit\n";
 
     while (!glfwWindowShouldClose(window)) {
@@ -380,46 +6665,157 @@ int main(int argc, char* argv[]) {
         if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
             glfwSetWindowShouldClose(window, true);
 
+        // --- 작업 스레드 결과가 준비되면 GL 업로드 (한 번만) ---
+        if (isReady(meshJob)) {
+            loadedMesh = meshJob.get();
+            if (!loadedMesh) {
+                std::cout << "OBJ load failed. Check models/cat.obj\n";
+                loadFailed = true;
+                break;
+            }
+            mesh = loadedMesh->view;
+            uploadMesh(mesh, meshBuffers);
+            fitMatrix = fitToSphere(mesh.sphereCenter, mesh.sphereRadius, fitRadius);
+            // MTL 재질이 있으면 그 텍스처들로, 없으면 기본 텍스처 하나로 그린다
+            if (mesh.materialCount > 0) materials.Start(mesh.materials, mesh.materialCount);
+
+            // 양자화 정점 복원용 bounds
+            if (useQuantizedVertices) {
+                glm::vec3 center, extent;
+                quantizationFrame(mesh.boundsMin, mesh.boundsMax, center, extent);
+                glUseProgram(program);
+                glUniform3fv(glGetUniformLocation(program, "boundsCenter"), 1, glm::value_ptr(center));
+                glUniform3fv(glGetUniformLocation(program, "boundsExtent"), 1, glm::value_ptr(extent));
+            }
+            if (benchmarkRays) {
+                std::cout << "Ray benchmark:\n";
+                benchmarkBvh(loadedMesh->bvh, mesh.sphereCenter, mesh.sphereRadius);
+            }
+            std::cout << "First mesh frame at " << glfwGetTime() << " s\n";
+        }
+        // --streaming: 이번 프레임에 도착한 배치만큼 버퍼 뒤에 붙인다
+        if (streamMesh) {
+            MeshBatch batch;
+            for (size_t i = 0; i < kStreamBatchesPerFrame && meshBatches.TryPop(batch); ++i) {
+                appendMeshBatch(streamingMesh, batch);
+                mesh = makeMeshView(streamingMesh, batch);
+                fitMatrix = fitToSphere(mesh.sphereCenter, mesh.sphereRadius, fitRadius);
+            }
+            if (isReady(streamJob) && !streamJob.get() && !streamingMesh.indexCount) {
+                std::cout << "OBJ load failed. Check models/cat.obj\n";
+                loadFailed = true;
+                break;
+            }
+        }
+        // 디코딩/복사가 끝난 텍스처를 PBO 에서 올린다 (GL_TEXTURE_2D 바인딩은 0 으로 돌아온다)
+        textureStreamer.Update();
+        textureManager.Poll();
+        texture = textureManager.Texture(textureHandle);
+
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        // 메시가 아직이면 배경만 그리고 이벤트를 계속 처리한다 (텍스처는 없어도 그린다)
+        if (mesh.indexCount == 0) {
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+            continue;
+        }
+
         glUseProgram(program);
-        glBindVertexArray(VAO);
+        glBindVertexArray(streamMesh ? streamingMesh.buffers.vao : meshBuffers.vao);
+        MaterialSet* meshMaterials = mesh.materialCount > 0 ? &materials : nullptr;
+        materials.BeginFrame();
+        glBindTexture(GL_TEXTURE_2D, texture); // 재질이 없을 때의 기본 텍스처 (아직이면 0)
 
-        // --- World: 위치 낮추기 + 자동 회전 + 세우기 ---
+        // --- World: 자동 회전 + 세우기 + 바운딩 구 맞춤 ---
         worldMatrix = glm::mat4(1.0f);
-        worldMatrix = glm::translate(worldMatrix, glm::vec3(0.0f, -1.5f, 0.0f)); // 고양이를 아래로
         worldMatrix = glm::rotate(worldMatrix, currentFrame * glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f)); // Y축 자동 회전
         worldMatrix = glm::rotate(worldMatrix, glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f)); // X축으로 세우기
-        worldMatrix = glm::scale(worldMatrix, glm::vec3(0.05f));
+        worldMatrix = worldMatrix * fitMatrix;
 
         // --- View: 마우스로 제어되는 카메라 ---
         viewMatrix = camera.GetViewMatrix();
 
-        // --- Projection ---
-        projMatrix = glm::perspective(glm::radians(45.0f),
+        // --- Projection: 모델 바운딩 구에 맞춘 near/far ---
+        float zNear, zFar;
+        depthRangeForSphere(glm::vec3(worldMatrix * glm::vec4(mesh.sphereCenter, 1.0f)), fitRadius,
+                            camera.position, zNear, zFar);
+        projMatrix = glm::perspective(fovY,
                                       800.0f / 600.0f,
-                                      0.1f, 100.0f);
+                                      zNear, zFar);
 
         glUniformMatrix4fv(worldMatLoc, 1, GL_FALSE, glm::value_ptr(worldMatrix));
         glUniformMatrix4fv(viewMatLoc,  1, GL_FALSE, glm::value_ptr(viewMatrix));
         glUniformMatrix4fv(projMatLoc,  1, GL_FALSE, glm::value_ptr(projMatrix));
 
-        glDrawElements(GL_TRIANGLES,
-                       (GLsizei)objData.indices.size(),
-                       GL_UNSIGNED_INT,
-                       0);
+        // 클릭: 카메라 정면 레이를 모델 공간으로 옮겨 BVH 질의
+        if (pickRequested) {
+            pickRequested = false;
+            if (!loadedMesh) {
+                std::cout << "Pick: no BVH (mesh still loading or streamed)\n";
+            } else {
+                glm::mat4 worldToModel = glm::inverse(worldMatrix);
+                Ray ray;
+                ray.origin = glm::vec3(worldToModel * glm::vec4(camera.position, 1.0f));
+                ray.dir = glm::vec3(worldToModel * glm::vec4(camera.GetFront(), 0.0f));
+                RayHit hit;
+                auto pickStart = std::chrono::steady_clock::now();
+                bool picked = intersectClosest(loadedMesh->bvh, ray, hit);
+                double pickUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - pickStart).count();
+                if (picked) {
+                    glm::vec3 modelPos = ray.origin + ray.dir * hit.t;
+                    glm::vec3 worldPos = glm::vec3(worldMatrix * glm::vec4(modelPos, 1.0f));
+                    std::cout << "Pick: triangle " << hit.triangle << ", bary (" << 1.0f - hit.u - hit.v << ", "
+                              << hit.u << ", " << hit.v << "), model (" << modelPos.x << ", " << modelPos.y << ", "
+                              << modelPos.z << "), world (" << worldPos.x << ", " << worldPos.y << ", " << worldPos.z
+                              << "), " << pickUs << " us\n";
+                } else {
+                    std::cout << "Pick: miss (" << pickUs << " us)\n";
+                }
+            }
+        }
+
+        // 화면에 작게 보일수록 거친 LOD
+        size_t lod = selectLod(mesh, worldMatrix, camera.position, fovY, 600.0f);
+        if (lod != currentLod && mesh.lodCount > 0) {
+            std::cout << "LOD " << lod << " (" << mesh.lods[lod].indexCount / 3 << " triangles)\n";
+            currentLod = lod;
+        }
+
+        if (useClusterCulling && mesh.meshletCount > 0) {
+            const Meshlet* meshlets = mesh.meshlets;
+            size_t meshletCount = mesh.meshletCount;
+            if (mesh.lodCount > 0) {
+                meshlets += mesh.lods[lod].meshletOffset;
+                meshletCount = mesh.lods[lod].meshletCount;
+            }
+            // 카메라를 모델 공간으로 옮겨 클러스터 바운드와 바로 비교
+            glm::vec3 cameraModelPos = glm::vec3(glm::inverse(worldMatrix) * glm::vec4(camera.position, 1.0f));
+            cullMeshlets(meshlets, meshletCount, projMatrix * viewMatrix * worldMatrix,
+                         cameraModelPos, meshletDraws.visible);
+            drawMeshlets(mesh, meshlets, meshletDraws, meshMaterials);
+        } else {
+            drawMesh(mesh, lod, meshMaterials);
+        }
 
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-    glDeleteTextures(1, &texture);
+    // 중간에 창을 닫았으면 작업이 끝날 때까지 기다렸다가 정리
+    meshBatches.Cancel();
+    if (streamJob.valid()) streamJob.wait();
+    if (meshJob.valid()) meshJob.wait();
+
+    deleteMesh(meshBuffers);
+    deleteMesh(streamingMesh.buffers);
+    textureManager.Release(textureHandle);
+    materials.Release();
+    textureManager.ReleaseAll();
+    textureStreamer.Release();
     glDeleteProgram(program);
 
     glfwTerminate();
-    return 0;
+    return loadFailed ? -1 : 0;
 }
\ No newline at end of file